@@ -1,12 +1,17 @@
 #include "search_server.h"
 #include "string_processing.h"
+#include "index_snapshot.h"
 
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <execution>
 #include <algorithm>
 #include <string_view>
 #include <utility>
 #include <numeric>
+#include <limits>
+#include <set>
 
 using std::string;
 using std::vector;
@@ -14,54 +19,232 @@ using std::invalid_argument;
 using std::tuple;
 using std::map;
 
-SearchServer::SearchServer(const std::string& stop_words_text)
-    : SearchServer(SplitIntoWords(stop_words_text))  // Invoke delegating constructor
-                                                     // from string container
+namespace {
+
+// Posting lists are stored in snapshots as they are laid out in memory
+static_assert(sizeof(Posting) == 16 && offsetof(Posting, term_freq) == 8);
+
+struct SnapshotDocument {
+    int32_t id;
+    int32_t rating;
+    int32_t status;
+    uint32_t term_count;
+    uint64_t word_count;
+};
+
+struct SnapshotTermFreq {
+    TermId term_id;
+    uint32_t reserved;
+    double term_freq;
+};
+
+} // namespace
+
+SearchServer::SearchServer(const std::string& stop_words_text, std::shared_ptr<ThreadPool> thread_pool,
+                           PostingFormat posting_format)
+    : SearchServer(SplitIntoWords(stop_words_text), std::move(thread_pool), posting_format)  // Invoke delegating constructor
+                                                                                            // from string container
 {
 }
 
-std::set<int>::const_iterator SearchServer::begin() const {
-    return document_ids_.begin();
+ThreadPool& SearchServer::GetThreadPool() const {
+    return *thread_pool_;
+}
+
+DocumentTable::ConstIterator SearchServer::begin() const {
+    return documents_.begin();
 }
 
-std::set<int>::const_iterator SearchServer::end() const {
-    return document_ids_.end();
+DocumentTable::ConstIterator SearchServer::end() const {
+    return documents_.end();
 }
 
 void SearchServer::AddDocument(int document_id, const std::string_view& document, 
                                DocumentStatus status, const vector<int>& ratings) {
-    if ((document_id < 0) || (documents_.count(document_id) > 0)) {
+    METRICS_STAGE(ADD_DOCUMENT);
+    if ((document_id < 0) || (documents_.Find(document_id) != DocumentTable::NO_DOCUMENT)) {
         throw invalid_argument("Invalid document_id"s);
     }
-    const auto words = SplitIntoWordsNoStop(document);
+    vector<std::string_view> words;
+    SplitIntoWordsNoStop(document, words);
+    METRICS_COUNT(INDEXED_WORDS, words.size());
+    const uint32_t internal_id = documents_.Add(document_id, ComputeAverageRating(ratings), status, words.size());
 
     const double inv_word_count = 1.0 / words.size();
+    vector<TermId> word_term_ids;
+    word_term_ids.reserve(words.size());
     for (const std::string_view& word : words) {
-        word_to_document_freqs_[std::string(word)][document_id] += inv_word_count;
-        document_to_word_freqs_[document_id][word] += inv_word_count;
+        const TermId term_id = terms_.Intern(word);
+        if (term_id == term_data_.size()) {
+            term_data_.emplace_back();
+        }
+        if (posting_format_ == PostingFormat::PLAIN) {
+            term_data_[term_id].postings.Add(internal_id, inv_word_count);
+        }
+        word_term_ids.push_back(term_id);
+    }
+    std::sort(word_term_ids.begin(), word_term_ids.end());
+    vector<TermFrequency> term_freqs;
+    for (const TermId term_id : word_term_ids) {
+        if (term_freqs.empty() || term_freqs.back().term_id != term_id) {
+            term_freqs.push_back({ term_id, 0.0 });
+        }
+        term_freqs.back().term_freq += inv_word_count;
     }
-    documents_.emplace(document_id, DocumentData{ ComputeAverageRating(ratings), status });
-    document_ids_.insert(document_id);
+    forward_index_.Set(internal_id, term_freqs);
+    for (const auto& [term_id, term_freq] : term_freqs) {
+        auto& term = term_data_[term_id];
+        if (posting_format_ == PostingFormat::COMPRESSED) {
+            term.compressed_postings.Add(internal_id, CountOccurrences(term_freq, words.size()));
+        }
+        term.max_term_freq = std::max(term.max_term_freq, term_freq);
+        UpdateLogDocumentFreq(term_id);
+    }
+    UpdateLogDocumentCount();
+    ++generation_;
+}
+
+vector<DocumentError> SearchServer::AddDocuments(const vector<DocumentInput>& documents) {
+    vector<string> error_messages(documents.size());
+    std::set<int> batch_ids;
+    for (size_t position = 0; position < documents.size(); ++position) {
+        const int document_id = documents[position].id;
+        if ((document_id < 0) || (documents_.Find(document_id) != DocumentTable::NO_DOCUMENT)
+            || !batch_ids.insert(document_id).second) {
+            error_messages[position] = "Invalid document_id"s;
+        }
+    }
+
+    static constexpr size_t BLOCKS_PER_THREAD = 2;
+    const size_t block_count = std::min(documents.size(), thread_pool_->GetThreadCount() * BLOCKS_PER_THREAD);
+    const auto block_begin = [&documents, block_count](size_t block) {
+        return documents.size() * block / block_count;
+    };
+    vector<PartialIndex> partial_indexes(block_count);
+    thread_pool_->ParallelFor(block_count,
+        [&](size_t block) {
+            partial_indexes[block] = BuildPartialIndex(documents, block_begin(block), block_begin(block + 1), error_messages);
+        }
+    );
+
+    // Interning is sequential, after it the blocks are merged term by term
+    vector<vector<TermId>> block_term_ids(block_count);
+    vector<vector<Posting>> new_postings;
+    vector<TermId> touched_terms;
+    for (size_t block = 0; block < block_count; ++block) {
+        auto& partial_index = partial_indexes[block];
+        auto& term_ids = block_term_ids[block];
+        term_ids.reserve(partial_index.words.size());
+        for (size_t word_id = 0; word_id < partial_index.words.size(); ++word_id) {
+            const TermId term_id = terms_.Intern(partial_index.words[word_id]);
+            if (term_id == term_data_.size()) {
+                term_data_.emplace_back();
+            }
+            if (term_id >= new_postings.size()) {
+                new_postings.resize(term_data_.size());
+            }
+            auto& term_postings = new_postings[term_id];
+            if (term_postings.empty()) {
+                touched_terms.push_back(term_id);
+            }
+            const auto& block_postings = partial_index.word_postings[word_id];
+            term_postings.insert(term_postings.end(), block_postings.begin(), block_postings.end());
+            term_ids.push_back(term_id);
+        }
+    }
+
+    vector<DocumentError> errors;
+    vector<uint32_t> internal_ids(documents.size(), DocumentTable::NO_DOCUMENT);
+    vector<TermFrequency> term_freqs;
+    for (size_t block = 0; block < block_count; ++block) {
+        const auto& partial_index = partial_indexes[block];
+        const auto& term_ids = block_term_ids[block];
+        for (size_t position = block_begin(block); position < block_begin(block + 1); ++position) {
+            const auto& document = documents[position];
+            if (!error_messages[position].empty()) {
+                errors.push_back({ position, document.id, std::move(error_messages[position]) });
+                continue;
+            }
+            term_freqs.clear();
+            for (const auto& [word_id, term_freq] : partial_index.document_word_freqs[position - block_begin(block)]) {
+                term_freqs.push_back({ term_ids[word_id], term_freq });
+            }
+            std::sort(term_freqs.begin(), term_freqs.end(),
+                [](const TermFrequency& lhs, const TermFrequency& rhs) {
+                    return lhs.term_id < rhs.term_id;
+                }
+            );
+            const uint32_t internal_id = documents_.Add(document.id, ComputeAverageRating(document.ratings),
+                document.status, partial_index.document_word_counts[position - block_begin(block)]);
+            forward_index_.Set(internal_id, term_freqs);
+            internal_ids[position] = internal_id;
+        }
+    }
+
+    // Postings get the internal ids given above, compressed ones take the word counts too
+    thread_pool_->ParallelFor(touched_terms.size(),
+        [this, &touched_terms, &new_postings, &internal_ids](size_t i) {
+            const TermId term_id = touched_terms[i];
+            auto& term_postings = new_postings[term_id];
+            for (auto& posting : term_postings) {
+                posting.document_id = internal_ids[posting.document_id];
+            }
+            std::sort(term_postings.begin(), term_postings.end(),
+                [](const Posting& lhs, const Posting& rhs) {
+                    return lhs.document_id < rhs.document_id;
+                }
+            );
+            auto& term = term_data_[term_id];
+            for (const Posting& posting : term_postings) {
+                term.max_term_freq = std::max(term.max_term_freq, posting.term_freq);
+            }
+            if (posting_format_ == PostingFormat::PLAIN) {
+                term.postings.Merge(term_postings);
+            }
+            else {
+                vector<PostingCount> posting_counts;
+                posting_counts.reserve(term_postings.size());
+                for (const auto& [internal_id, term_freq] : term_postings) {
+                    posting_counts.push_back({ internal_id,
+                        CountOccurrences(term_freq, documents_.GetWordCount(internal_id)) });
+                }
+                term.compressed_postings.Merge(posting_counts);
+            }
+            UpdateLogDocumentFreq(term_id);
+        }
+    );
+    UpdateLogDocumentCount();
+    ++generation_;
+    return errors;
 }
 
 std::vector<Document> SearchServer::FindTopDocuments(const std::string_view raw_query) const {
     return FindTopDocuments(raw_query, DocumentStatus::ACTUAL);
 }
-std::vector<Document> SearchServer::FindTopDocuments(const std::string_view raw_query, DocumentStatus status) const {
-    return FindTopDocuments(raw_query, [status](int document_id, DocumentStatus document_status, int rating) {
-        return document_status == status;
-        });
+std::vector<Document> SearchServer::FindTopDocuments(const std::string_view raw_query, DocumentStatus status, size_t max_result_count) const {
+    return FindTopDocuments(std::execution::seq, raw_query, status, max_result_count);
 }
-std::vector<Document> SearchServer::FindTopDocuments(const std::execution::sequenced_policy&, const std::string_view raw_query, DocumentStatus status) const {
-    return FindTopDocuments(std::execution::seq, raw_query, [status](int document_id, DocumentStatus document_status, int rating) {
-        return document_status == status;
-        });
+std::vector<Document> SearchServer::FindTopDocuments(const std::execution::sequenced_policy&, const std::string_view raw_query, DocumentStatus status, size_t max_result_count) const {
+    return FindTopFilteredDocuments(std::execution::seq, raw_query, status, std::nullopt, max_result_count);
 }
 
-std::vector<Document> SearchServer::FindTopDocuments(const std::execution::parallel_policy&, const std::string_view raw_query, DocumentStatus status) const {
-    return FindTopDocuments(std::execution::par, raw_query, [status](int document_id, DocumentStatus document_status, int rating) {
-        return document_status == status;
-        });
+std::vector<Document> SearchServer::FindTopDocuments(const std::execution::parallel_policy&, const std::string_view raw_query, DocumentStatus status, size_t max_result_count) const {
+    return FindTopFilteredDocuments(std::execution::par, raw_query, status, std::nullopt, max_result_count);
+}
+
+std::vector<Document> SearchServer::FindTopDocuments(const std::string_view raw_query, DocumentStatus status,
+                                                     RatingRange ratings, size_t max_result_count) const {
+    return FindTopDocuments(std::execution::seq, raw_query, status, ratings, max_result_count);
+}
+
+std::vector<Document> SearchServer::FindTopDocuments(const std::execution::sequenced_policy&, const std::string_view raw_query,
+                                                     DocumentStatus status, RatingRange ratings, size_t max_result_count) const {
+    return FindTopFilteredDocuments(std::execution::seq, raw_query, status, ratings, max_result_count);
+}
+
+std::vector<Document> SearchServer::FindTopDocuments(const std::execution::parallel_policy&, const std::string_view raw_query,
+                                                     DocumentStatus status, RatingRange ratings, size_t max_result_count) const {
+    return FindTopFilteredDocuments(std::execution::par, raw_query, status, ratings, max_result_count);
 }
 
 std::vector<Document> SearchServer::FindTopDocuments(const std::execution::sequenced_policy&, const std::string_view raw_query) const {
@@ -72,36 +255,453 @@ std::vector<Document> SearchServer::FindTopDocuments(const std::execution::paral
     return FindTopDocuments(std::execution::par, raw_query, DocumentStatus::ACTUAL);
 }
 
+QueryBatchResults SearchServer::FindTopDocumentsBatch(const vector<string>& raw_queries, DocumentStatus status,
+                                                     size_t max_result_count) const {
+    METRICS_STAGE(PROCESS_QUERIES);
+    METRICS_COUNT(BATCH_QUERIES, raw_queries.size());
+    static constexpr size_t TASKS_PER_THREAD = 4;
+    static constexpr uint32_t NO_BATCH_TERM = std::numeric_limits<uint32_t>::max();
+    const size_t query_count = raw_queries.size();
+    const size_t task_count = std::min(query_count, thread_pool_->GetThreadCount() * TASKS_PER_THREAD);
+
+    // Plus words of a query are kept in the order of query.plus_words, so scores are summed as FindTopDocuments sums them
+    struct BatchQuery {
+        Query query;
+        std::vector<uint32_t> plus_terms;
+        std::pmr::vector<const TermData*> minus_terms;
+    };
+    vector<BatchQuery> queries(query_count);
+    vector<vector<TermId>> plus_term_ids(query_count);
+    thread_pool_->ParallelFor(task_count,
+        [&](size_t task) {
+            for (size_t i = query_count * task / task_count; i < query_count * (task + 1) / task_count; ++i) {
+                auto& batch_query = queries[i];
+                batch_query.query = ParseQuery(raw_queries[i]);
+                for (const std::string_view word : batch_query.query.plus_words) {
+                    const TermId term_id = terms_.Find(word);
+                    if (term_id != TermDictionary::NO_TERM && GetPostingCount(term_data_[term_id]) > 0) {
+                        plus_term_ids[i].push_back(term_id);
+                    }
+                }
+                for (const std::string_view word : batch_query.query.minus_words) {
+                    if (const auto* term = FindTerm(word)) {
+                        batch_query.minus_terms.push_back(term);
+                    }
+                }
+            }
+        }
+    );
+
+    // Every distinct plus word of the batch gets its postings and IDF once
+    vector<uint32_t> batch_term_indices(term_data_.size(), NO_BATCH_TERM);
+    vector<WordPostings> batch_terms;
+    for (size_t i = 0; i < query_count; ++i) {
+        queries[i].plus_terms.reserve(plus_term_ids[i].size());
+        for (const TermId term_id : plus_term_ids[i]) {
+            if (batch_term_indices[term_id] == NO_BATCH_TERM) {
+                batch_term_indices[term_id] = static_cast<uint32_t>(batch_terms.size());
+                const TermData& term = term_data_[term_id];
+                batch_terms.push_back({ &term, GetInverseDocumentFreq(term) });
+            }
+            queries[i].plus_terms.push_back(batch_term_indices[term_id]);
+        }
+    }
+
+    // Queries are grouped by the longest list they read, which is most of their work
+    vector<uint32_t> longest_terms(query_count, NO_BATCH_TERM);
+    for (size_t i = 0; i < query_count; ++i) {
+        size_t longest_length = 0;
+        for (const uint32_t batch_term : queries[i].plus_terms) {
+            const size_t length = GetStoredPostingCount(*batch_terms[batch_term].term);
+            if (length > longest_length) {
+                longest_length = length;
+                longest_terms[i] = batch_term;
+            }
+        }
+    }
+    vector<size_t> order(query_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+        [&longest_terms](size_t lhs, size_t rhs) {
+            return longest_terms[lhs] < longest_terms[rhs];
+        }
+    );
+
+    // Query i writes its top into slot i, and the slots are packed together afterwards
+    const size_t slot_length = std::min(max_result_count, documents_.size());
+    QueryBatchResults results;
+    results.documents.resize(query_count * slot_length);
+    vector<size_t> result_counts(query_count, 0);
+    const DocumentStatusFilter status_filter{ status, RatingRange{} };
+    std::optional<size_t> top_count;
+    if (dynamic_pruning_) {
+        top_count = max_result_count;
+    }
+    thread_pool_->ParallelFor(task_count,
+        [&](size_t task) {
+            for (size_t j = query_count * task / task_count; j < query_count * (task + 1) / task_count; ++j) {
+                const size_t i = order[j];
+                const auto& batch_query = queries[i];
+                const auto result_slot = results.documents.begin() + i * slot_length;
+                string key;
+                if (result_cache_) {
+                    key = MakeResultCacheKey(batch_query.query, status, std::nullopt, max_result_count);
+                    if (const auto cached_documents = result_cache_->Find(key, generation_)) {
+                        std::copy(cached_documents->begin(), cached_documents->end(), result_slot);
+                        result_counts[i] = cached_documents->size();
+                        continue;
+                    }
+                }
+
+                QueryArena arena;
+                std::pmr::vector<WordPostings> plus_word_postings(arena.GetResource());
+                plus_word_postings.reserve(batch_query.plus_terms.size());
+                for (const uint32_t batch_term : batch_query.plus_terms) {
+                    plus_word_postings.push_back(batch_terms[batch_term]);
+                }
+                auto matched_documents = posting_format_ == PostingFormat::PLAIN
+                    ? FindDocumentsAtATime<PostingList::Cursor>(plus_word_postings, batch_query.minus_terms,
+                        status_filter, top_count, arena.GetResource())
+                    : FindDocumentsAtATime<CompressedPostingList::Cursor>(plus_word_postings, batch_query.minus_terms,
+                        status_filter, top_count, arena.GetResource());
+                {
+                    METRICS_STAGE(TOP_SELECTION);
+                    SelectTopDocuments(std::execution::seq, matched_documents, max_result_count);
+                }
+                if (result_cache_) {
+                    result_cache_->Insert(std::move(key), generation_,
+                        vector<Document>(matched_documents.begin(), matched_documents.end()));
+                }
+                std::copy(matched_documents.begin(), matched_documents.end(), result_slot);
+                result_counts[i] = matched_documents.size();
+            }
+        }
+    );
+
+    results.offsets.resize(query_count + 1, 0);
+    for (size_t i = 0; i < query_count; ++i) {
+        results.offsets[i + 1] = results.offsets[i] + result_counts[i];
+        // Packed positions never pass slot positions, so slots are moved in place
+        std::move(results.documents.begin() + i * slot_length,
+            results.documents.begin() + i * slot_length + result_counts[i],
+            results.documents.begin() + results.offsets[i]);
+    }
+    results.documents.resize(results.offsets.back());
+    return results;
+}
+
 int SearchServer::GetDocumentCount() const {
     return documents_.size();
 }
 
+size_t SearchServer::GetDocumentFreq(std::string_view word) const {
+    const auto* term = FindTerm(word);
+    return term ? GetPostingCount(*term) : 0;
+}
+
 std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(
     const std::string_view raw_query, int document_id) const {
-    return MatchDocument(std::execution::seq, raw_query, document_id);
+    const auto& document_terms = GetDocumentTerms(document_id);
+    QueryArena arena;
+    const auto query = ParseQuery(raw_query, arena.GetResource());
+    return { MatchDocumentTerms(query, FindMatchTerms(query), document_terms),
+             documents_.GetStatus(documents_.Find(document_id)) };
+}
+
+vector<tuple<vector<std::string_view>, DocumentStatus>> SearchServer::MatchDocuments(
+    const std::string_view raw_query, const vector<int>& document_ids) const {
+    static constexpr size_t TASKS_PER_THREAD = 4;
+    vector<TermFrequencies> documents_terms;
+    documents_terms.reserve(document_ids.size());
+    for (const int document_id : document_ids) {
+        documents_terms.push_back(GetDocumentTerms(document_id));
+    }
+
+    QueryArena arena;
+    const auto query = ParseQuery(raw_query, arena.GetResource());
+    const auto terms = FindMatchTerms(query);
+
+    const size_t document_count = document_ids.size();
+    vector<tuple<vector<std::string_view>, DocumentStatus>> results(document_count);
+    const size_t task_count = std::min(document_count, thread_pool_->GetThreadCount() * TASKS_PER_THREAD);
+    thread_pool_->ParallelFor(task_count,
+        [&](size_t task) {
+            for (size_t i = document_count * task / task_count; i < document_count * (task + 1) / task_count; ++i) {
+                results[i] = { MatchDocumentTerms(query, terms, documents_terms[i]),
+                               documents_.GetStatus(documents_.Find(document_ids[i])) };
+            }
+        }
+    );
+    return results;
+}
+
+TermFrequencies SearchServer::GetWordFrequencies(int document_id) const {
+    const uint32_t internal_id = documents_.Find(document_id);
+    return internal_id == DocumentTable::NO_DOCUMENT ? TermFrequencies{} : forward_index_.Get(internal_id);
+}
+
+std::string_view SearchServer::GetWord(TermId term_id) const {
+    return terms_.GetWord(term_id);
+}
+
+void SearchServer::SetDynamicPruning(bool enabled) {
+    dynamic_pruning_ = enabled;
 }
 
-const map<std::string_view, double>& SearchServer::GetWordFrequencies(int document_id) const {
-    if (document_ids_.count(document_id) == 0) {
-        map<std::string_view, double> document_empty;
-        return document_empty;
+size_t SearchServer::GetScoredPostingCount() const {
+    return *scored_posting_count_;
+}
+
+void SearchServer::SetResultCacheCapacity(size_t capacity) {
+    if (capacity == 0) {
+        result_cache_.reset();
+    }
+    else {
+        result_cache_ = std::make_shared<QueryResultCache>(capacity);
     }
-    return document_to_word_freqs_.at(document_id);
+}
+
+QueryResultCacheStats SearchServer::GetResultCacheStats() const {
+    return result_cache_ ? result_cache_->GetStats() : QueryResultCacheStats{};
+}
+
+size_t SearchServer::GetPostingsMemoryUsage() const {
+    size_t memory_usage = 0;
+    for (const auto& term : term_data_) {
+        memory_usage += posting_format_ == PostingFormat::PLAIN
+            ? term.postings.MemoryUsage()
+            : term.compressed_postings.MemoryUsage();
+    }
+    return memory_usage;
 }
 
 void SearchServer::RemoveDocument(int document_id) {
-    if (!document_ids_.count(document_id)) {
+    RemoveDocument(std::execution::seq, document_id);
+}
+
+void SearchServer::RemoveDocuments(const vector<int>& document_ids) {
+    vector<uint32_t> internal_ids;
+    internal_ids.reserve(document_ids.size());
+    for (const int document_id : document_ids) {
+        const uint32_t internal_id = documents_.Find(document_id);
+        if (internal_id != DocumentTable::NO_DOCUMENT) {
+            internal_ids.push_back(internal_id);
+        }
+    }
+    std::sort(internal_ids.begin(), internal_ids.end());
+    internal_ids.erase(std::unique(internal_ids.begin(), internal_ids.end()), internal_ids.end());
+
+    // Internal ids of the removed postings of each term are counted, then laid out
+    // term after term, each term's in increasing order
+    vector<size_t> term_begins(term_data_.size() + 1, 0);
+    vector<TermId> document_term_ids;
+    vector<size_t> document_term_counts;
+    document_term_counts.reserve(internal_ids.size());
+    for (const uint32_t internal_id : internal_ids) {
+        const auto term_freqs = forward_index_.Get(internal_id);
+        for (const auto& [term_id, _] : term_freqs) {
+            ++term_begins[term_id + 1];
+            document_term_ids.push_back(term_id);
+        }
+        document_term_counts.push_back(term_freqs.size());
+    }
+    vector<TermId> term_ids;
+    for (TermId term_id = 0; term_id < term_data_.size(); ++term_id) {
+        if (term_begins[term_id + 1] > 0) {
+            term_ids.push_back(term_id);
+        }
+        term_begins[term_id + 1] += term_begins[term_id];
+    }
+    vector<int> posting_ids(term_begins.back());
+    vector<size_t> term_ends(term_begins.begin(), term_begins.end() - 1);
+    auto term_id_it = document_term_ids.begin();
+    for (size_t i = 0; i < internal_ids.size(); ++i) {
+        for (const auto end = term_id_it + document_term_counts[i]; term_id_it != end; ++term_id_it) {
+            posting_ids[term_ends[*term_id_it]++] = static_cast<int>(internal_ids[i]);
+        }
+    }
+
+    static constexpr size_t TASKS_PER_THREAD = 4;
+    const size_t task_count = std::min(term_ids.size(), thread_pool_->GetThreadCount() * TASKS_PER_THREAD);
+    thread_pool_->ParallelFor(task_count,
+        [this, &term_ids, &term_begins, &posting_ids, task_count](size_t task) {
+            vector<int> term_posting_ids;
+            for (size_t i = term_ids.size() * task / task_count; i < term_ids.size() * (task + 1) / task_count; ++i) {
+                const TermId term_id = term_ids[i];
+                term_posting_ids.assign(posting_ids.begin() + term_begins[term_id],
+                    posting_ids.begin() + term_begins[term_id + 1]);
+                RemovePostings(term_data_[term_id], term_posting_ids);
+                UpdateLogDocumentFreq(term_id);
+            }
+        }
+    );
+
+    for (const uint32_t internal_id : internal_ids) {
+        documents_.Remove(internal_id);
+        forward_index_.Remove(internal_id);
+    }
+    CompactInternalIds();
+    UpdateLogDocumentCount();
+    ++generation_;
+}
+
+void SearchServer::CompactInternalIds() {
+    if (documents_.GetFreeCount() <= documents_.size()) {
         return;
     }
-    documents_.erase(document_id);
+    const vector<uint32_t> new_ids = documents_.Renumber();
+    forward_index_.Renumber(new_ids);
+    static constexpr size_t TASKS_PER_THREAD = 4;
+    const size_t task_count = std::min(term_data_.size(), thread_pool_->GetThreadCount() * TASKS_PER_THREAD);
+    thread_pool_->ParallelFor(task_count,
+        [this, &new_ids, task_count](size_t task) {
+            for (size_t i = term_data_.size() * task / task_count; i < term_data_.size() * (task + 1) / task_count; ++i) {
+                if (posting_format_ == PostingFormat::PLAIN) {
+                    term_data_[i].postings.Renumber(new_ids);
+                }
+                else {
+                    term_data_[i].compressed_postings.Renumber(new_ids);
+                }
+            }
+        }
+    );
+}
 
-    document_ids_.erase(document_ids_.find(document_id));
+void SearchServer::SaveSnapshot(const string& path) const {
+    SnapshotWriter writer(path);
 
-    for (const auto& [word, _] : document_to_word_freqs_.at(document_id)) {
-        word_to_document_freqs_.erase(std::string(word));
+    writer.Write<uint64_t>(stop_words_.size());
+    for (const string& stop_word : stop_words_) {
+        writer.Write<uint64_t>(stop_word.size());
+        writer.WriteBytes(stop_word);
     }
 
-    document_to_word_freqs_.erase(document_id);
+    // Words of all terms back to back, then the postings of all terms without removed ones
+    const size_t term_count = terms_.size();
+    vector<uint64_t> offsets(term_count + 1);
+    string text;
+    for (TermId term_id = 0; term_id < term_count; ++term_id) {
+        text += terms_.GetWord(term_id);
+        offsets[term_id + 1] = text.size();
+    }
+    writer.Write<uint64_t>(term_count);
+    writer.WriteArray(offsets.data(), offsets.size());
+    writer.WriteBytes(text);
+    for (TermId term_id = 0; term_id < term_count; ++term_id) {
+        offsets[term_id + 1] = offsets[term_id] + GetPostingCount(term_data_[term_id]);
+    }
+    writer.WriteArray(offsets.data(), offsets.size());
+    // Documents are renumbered by the order of their internal ids, which keeps postings sorted
+    vector<uint32_t> snapshot_ids(documents_.GetInternalIdBound(), DocumentTable::NO_DOCUMENT);
+    vector<uint32_t> internal_ids;
+    internal_ids.reserve(documents_.size());
+    for (uint32_t internal_id = 0; internal_id < snapshot_ids.size(); ++internal_id) {
+        if (documents_.IsUsed(internal_id)) {
+            snapshot_ids[internal_id] = static_cast<uint32_t>(internal_ids.size());
+            internal_ids.push_back(internal_id);
+        }
+    }
+    for (const auto& term : term_data_) {
+        ForEachPosting(term, 0, GetStoredPostingCount(term),
+            [&writer, &snapshot_ids](uint32_t internal_id, double term_freq) {
+                writer.Write(Posting{ static_cast<int>(snapshot_ids[internal_id]), term_freq });
+            }
+        );
+    }
+    writer.Align();
+    for (const auto& term : term_data_) {
+        writer.Write(term.max_term_freq);
+    }
+
+    vector<SnapshotDocument> documents;
+    documents.reserve(internal_ids.size());
+    for (const uint32_t internal_id : internal_ids) {
+        const int document_id = documents_.GetDocumentId(internal_id);
+        documents.push_back({ document_id, documents_.GetRating(internal_id),
+            static_cast<int32_t>(documents_.GetStatus(internal_id)),
+            static_cast<uint32_t>(forward_index_.Get(internal_id).size()), documents_.GetWordCount(internal_id) });
+    }
+    writer.Write<uint64_t>(documents.size());
+    writer.WriteArray(documents.data(), documents.size());
+    for (const uint32_t internal_id : internal_ids) {
+        for (const auto& [term_id, term_freq] : forward_index_.Get(internal_id)) {
+            writer.Write(SnapshotTermFreq{ term_id, 0, term_freq });
+        }
+    }
+    writer.Finish();
+}
+
+SearchServer SearchServer::LoadSnapshot(const string& path, std::shared_ptr<ThreadPool> thread_pool) {
+    auto file = std::make_shared<const MappedFile>(path);
+    SnapshotReader reader(file->data(), file->size());
+
+    vector<string> stop_words;
+    for (uint64_t stop_word_count = reader.Read<uint64_t>(); stop_word_count > 0; --stop_word_count) {
+        const uint64_t size = reader.Read<uint64_t>();
+        stop_words.emplace_back(reader.ReadBytes(size));
+    }
+    SearchServer server(stop_words, std::move(thread_pool));
+    server.snapshot_file_ = file;
+
+    const uint64_t term_count = reader.Read<uint64_t>();
+    if (term_count >= TermDictionary::NO_TERM) {
+        throw std::runtime_error("Snapshot has too many terms");
+    }
+    const uint64_t* word_offsets = reader.ReadArray<uint64_t>(term_count + 1);
+    const std::string_view text = reader.ReadBytes(word_offsets[term_count]);
+    const uint64_t* posting_offsets = reader.ReadArray<uint64_t>(term_count + 1);
+    const Posting* postings = reader.ReadArray<Posting>(posting_offsets[term_count]);
+    const double* max_term_freqs = reader.ReadArray<double>(term_count);
+    server.term_data_.resize(term_count);
+    for (TermId term_id = 0; term_id < term_count; ++term_id) {
+        if (word_offsets[term_id] > word_offsets[term_id + 1] || posting_offsets[term_id] > posting_offsets[term_id + 1]) {
+            throw std::runtime_error("Snapshot has invalid offsets");
+        }
+        const auto word = text.substr(word_offsets[term_id], word_offsets[term_id + 1] - word_offsets[term_id]);
+        if (server.terms_.InternStored(word) != term_id) {
+            throw std::runtime_error("Snapshot has a repeated word");
+        }
+        server.term_data_[term_id].postings.AssignView(postings + posting_offsets[term_id],
+            posting_offsets[term_id + 1] - posting_offsets[term_id]);
+        server.term_data_[term_id].max_term_freq = max_term_freqs[term_id];
+        server.UpdateLogDocumentFreq(term_id);
+    }
+
+    // Postings refer to documents by their position in the snapshot, which becomes their internal id
+    const uint64_t document_count = reader.Read<uint64_t>();
+    if (std::any_of(postings, postings + posting_offsets[term_count],
+        [document_count](const Posting& posting) {
+            return posting.document_id < 0 || static_cast<uint64_t>(posting.document_id) >= document_count;
+        })) {
+        throw std::runtime_error("Snapshot has an invalid posting");
+    }
+    const SnapshotDocument* documents = reader.ReadArray<SnapshotDocument>(document_count);
+    vector<TermFrequency> term_freqs;
+    for (uint64_t i = 0; i < document_count; ++i) {
+        const auto& document = documents[i];
+        if (document.id < 0 || document.status < 0 || document.status > static_cast<int32_t>(DocumentStatus::REMOVED)
+            || server.documents_.Find(document.id) != DocumentTable::NO_DOCUMENT) {
+            throw std::runtime_error("Snapshot has an invalid document");
+        }
+        const uint32_t internal_id = server.documents_.Add(document.id, document.rating,
+            static_cast<DocumentStatus>(document.status), static_cast<size_t>(document.word_count));
+        term_freqs.clear();
+        const SnapshotTermFreq* document_term_freqs = reader.ReadArray<SnapshotTermFreq>(document.term_count);
+        for (uint32_t j = 0; j < document.term_count; ++j) {
+            // Terms are written in increasing order
+            if (document_term_freqs[j].term_id >= term_count
+                || (j > 0 && document_term_freqs[j].term_id <= document_term_freqs[j - 1].term_id)) {
+                throw std::runtime_error("Snapshot has an invalid term");
+            }
+            term_freqs.push_back({ document_term_freqs[j].term_id, document_term_freqs[j].term_freq });
+        }
+        server.forward_index_.Set(internal_id, term_freqs);
+    }
+    if (!reader.AtEnd()) {
+        throw std::runtime_error("Snapshot has trailing data");
+    }
+    server.UpdateLogDocumentCount();
+    return server;
 }
 
 /*   */
@@ -112,23 +712,129 @@ bool SearchServer::IsStopWord(const std::string_view& word) const {
 
 bool SearchServer::IsValidWord(const std::string_view& word) {
     // A valid word must not contain special characters
-    return none_of(word.begin(), word.end(), [](char c) {
+    return std::none_of(word.begin(), word.end(), [](char c) {
         return c >= '\0' && c < ' ';
         });
 }
 
-std::vector<std::string_view> SearchServer::SplitIntoWordsNoStop(const std::string_view& text) const {
-    std::vector<std::string_view> words;
-    for (const std::string_view& word : SplitIntoWords(text)) {
-        if (!IsValidWord(word)) {
-            throw invalid_argument("Word "s + std::string(word) + " is invalid"s);
+void SearchServer::SplitIntoWordsNoStop(std::string_view text, vector<std::string_view>& words) const {
+    const size_t invalid_position = SplitIntoValidWords(text, words);
+    if (invalid_position != std::string_view::npos) {
+        const auto invalid_word = *std::find_if(words.begin(), words.end(),
+            [&text, invalid_position](std::string_view word) {
+                return word.data() + word.size() > text.data() + invalid_position;
+            }
+        );
+        throw invalid_argument("Word "s + std::string(invalid_word) + " is invalid"s);
+    }
+    if (!stop_words_.empty()) {
+        words.erase(std::remove_if(words.begin(), words.end(),
+            [this](std::string_view word) {
+                return IsStopWord(word);
+            }
+        ), words.end());
+    }
+}
+
+void SearchServer::CopyDocuments(const SearchServer& other, const vector<uint32_t>& internal_ids) {
+    // Every id is checked before anything changes, so that a clash leaves the server as it was
+    for (const uint32_t other_internal_id : internal_ids) {
+        if (documents_.Find(other.documents_.GetDocumentId(other_internal_id)) != DocumentTable::NO_DOCUMENT) {
+            throw invalid_argument("Invalid document_id"s);
         }
-        if (!IsStopWord(word)) {
-            words.push_back(word);
+    }
+
+    // Term ids of other mapped to the ids of this server
+    vector<TermId> term_ids(other.terms_.size(), TermDictionary::NO_TERM);
+    vector<TermId> touched_terms;
+    vector<TermFrequency> term_freqs;
+    for (const uint32_t other_internal_id : internal_ids) {
+        const int document_id = other.documents_.GetDocumentId(other_internal_id);
+        const DocumentStatus status = other.documents_.GetStatus(other_internal_id);
+        const size_t word_count = other.documents_.GetWordCount(other_internal_id);
+        const uint32_t internal_id = documents_.Add(document_id, other.documents_.GetRating(other_internal_id),
+            status, word_count);
+
+        term_freqs.clear();
+        for (const auto& [other_term_id, term_freq] : other.forward_index_.Get(other_internal_id)) {
+            TermId& term_id = term_ids[other_term_id];
+            if (term_id == TermDictionary::NO_TERM) {
+                term_id = terms_.Intern(other.terms_.GetWord(other_term_id));
+                if (term_id == term_data_.size()) {
+                    term_data_.emplace_back();
+                }
+                touched_terms.push_back(term_id);
+            }
+            term_freqs.push_back({ term_id, term_freq });
+            auto& term = term_data_[term_id];
+            if (posting_format_ == PostingFormat::PLAIN) {
+                term.postings.Add(internal_id, term_freq);
+            }
+            else {
+                term.compressed_postings.Add(internal_id, CountOccurrences(term_freq, word_count));
+            }
+            term.max_term_freq = std::max(term.max_term_freq, term_freq);
         }
+        std::sort(term_freqs.begin(), term_freqs.end(),
+            [](const TermFrequency& lhs, const TermFrequency& rhs) {
+                return lhs.term_id < rhs.term_id;
+            }
+        );
+        forward_index_.Set(internal_id, term_freqs);
     }
+    for (const TermId term_id : touched_terms) {
+        UpdateLogDocumentFreq(term_id);
+    }
+    UpdateLogDocumentCount();
+    ++generation_;
+}
 
-    return words;
+SearchServer::PartialIndex SearchServer::BuildPartialIndex(const vector<DocumentInput>& documents,
+    size_t first, size_t last, vector<string>& error_messages) const {
+    PartialIndex partial_index;
+    partial_index.document_word_freqs.resize(last - first);
+    partial_index.document_word_counts.resize(last - first);
+    vector<TermId> word_ids;
+    vector<std::string_view> words;
+    for (size_t position = first; position < last; ++position) {
+        if (!error_messages[position].empty()) {
+            continue;
+        }
+        const auto& document = documents[position];
+        try {
+            SplitIntoWordsNoStop(document.text, words);
+        }
+        catch (const invalid_argument& error) {
+            error_messages[position] = error.what();
+            continue;
+        }
+
+        word_ids.clear();
+        for (const std::string_view word : words) {
+            const auto [word_it, inserted] = partial_index.word_ids.emplace(word, partial_index.words.size());
+            if (inserted) {
+                partial_index.words.push_back(word);
+                partial_index.word_postings.emplace_back();
+            }
+            word_ids.push_back(word_it->second);
+        }
+        std::sort(word_ids.begin(), word_ids.end());
+
+        // Term freqs are summed the same way as in AddDocument
+        const double inv_word_count = 1.0 / words.size();
+        partial_index.document_word_counts[position - first] = words.size();
+        auto& word_freqs = partial_index.document_word_freqs[position - first];
+        for (size_t i = 0; i < word_ids.size();) {
+            const TermId word_id = word_ids[i];
+            double term_freq = 0.0;
+            for (; i < word_ids.size() && word_ids[i] == word_id; ++i) {
+                term_freq += inv_word_count;
+            }
+            word_freqs.push_back({ word_id, term_freq });
+            partial_index.word_postings[word_id].push_back({ static_cast<int>(position), term_freq });
+        }
+    }
+    return partial_index;
 }
 
 int SearchServer::ComputeAverageRating(const vector<int>& ratings) {
@@ -142,7 +848,7 @@ int SearchServer::ComputeAverageRating(const vector<int>& ratings) {
     return rating_sum / static_cast<int>(ratings.size());
 }
 
-SearchServer::QueryWord SearchServer::ParseQueryWord(const std::string_view& text) const {
+SearchServer::QueryWord SearchServer::ParseQueryWord(const std::string_view& text, bool may_be_invalid) const {
     if (text.empty()) {
         throw invalid_argument("Query word is empty"s);
     }
@@ -152,29 +858,255 @@ SearchServer::QueryWord SearchServer::ParseQueryWord(const std::string_view& tex
         is_minus = true;
         word = word.substr(1);
     }
-    if (word.empty() || word[0] == '-' || !IsValidWord(word)) {
+    if (word.empty() || word[0] == '-' || (may_be_invalid && !IsValidWord(word))) {
         throw invalid_argument("Query word "s + string(word) + " is invalid");
     }
 
     return { word, is_minus, IsStopWord(word) };
 }
 
-SearchServer::Query SearchServer::ParseQuery(const std::string_view& text) const {
-    Query result;
-    for (const std::string_view& word : SplitIntoWords(text)) {
-        const auto query_word = ParseQueryWord(word);
+SearchServer::Query SearchServer::ParseQuery(const std::string_view& text, std::pmr::memory_resource* resource) const {
+    METRICS_STAGE(PARSE);
+    // The thread keeps room for at most this many words between queries
+    static constexpr size_t MAX_RETAINED_WORD_COUNT = 64 * 1024;
+    Query result{ std::pmr::vector<std::string_view>(resource), std::pmr::vector<std::string_view>(resource) };
+    static thread_local vector<std::string_view> words;
+    const bool may_be_invalid = SplitIntoValidWords(text, words) != std::string_view::npos;
+    result.plus_words.reserve(words.size());
+    for (const std::string_view& word : words) {
+        const auto query_word = ParseQueryWord(word, may_be_invalid);
         if (!query_word.is_stop) {
             if (query_word.is_minus) {
-                result.minus_words.insert(query_word.data);
+                result.minus_words.push_back(query_word.data);
             }
             else {
-                result.plus_words.insert(query_word.data);
+                result.plus_words.push_back(query_word.data);
             }
         }
     }
+    if (words.capacity() > MAX_RETAINED_WORD_COUNT) {
+        vector<std::string_view> retained_words;
+        retained_words.reserve(MAX_RETAINED_WORD_COUNT);
+        words.swap(retained_words);
+    }
+    for (auto* query_words : { &result.plus_words, &result.minus_words }) {
+        std::sort(query_words->begin(), query_words->end());
+        query_words->erase(std::unique(query_words->begin(), query_words->end()), query_words->end());
+    }
     return result;
 }
 
-double SearchServer::ComputeWordInverseDocumentFreq(const std::string_view& word) const {
-    return log(GetDocumentCount() * 1.0 / word_to_document_freqs_.at(std::string(word)).size());
+std::string SearchServer::MakeResultCacheKey(const Query& query, DocumentStatus status,
+                                             const std::optional<RatingRange>& ratings, size_t max_result_count) {
+    // Words have no control characters, so these cannot be mistaken for them
+    static constexpr char WORD_END = '\x01';
+    static constexpr char LIST_END = '\x02';
+    const auto append_number = [](string& key, auto number) {
+        key.append(reinterpret_cast<const char*>(&number), sizeof(number));
+    };
+
+    string key;
+    for (const std::string_view word : query.plus_words) {
+        key += word;
+        key += WORD_END;
+    }
+    key += LIST_END;
+    for (const std::string_view word : query.minus_words) {
+        key += word;
+        key += WORD_END;
+    }
+    key += LIST_END;
+    const RatingRange rating_range = ratings.value_or(RatingRange{});
+    append_number(key, static_cast<int32_t>(status));
+    append_number(key, rating_range.min);
+    append_number(key, rating_range.max);
+    append_number(key, static_cast<uint64_t>(max_result_count));
+    return key;
+}
+
+SearchServer::MatchTerms SearchServer::FindMatchTerms(const Query& query) const {
+    MatchTerms terms{ std::pmr::vector<std::pair<TermId, size_t>>(query.GetResource()),
+                      std::pmr::vector<TermId>(query.GetResource()) };
+    terms.plus_terms.reserve(query.plus_words.size());
+    for (size_t i = 0; i < query.plus_words.size(); ++i) {
+        const TermId term_id = terms_.Find(query.plus_words[i]);
+        if (term_id != TermDictionary::NO_TERM) {
+            terms.plus_terms.push_back({ term_id, i });
+        }
+    }
+    std::sort(terms.plus_terms.begin(), terms.plus_terms.end());
+    terms.minus_terms.reserve(query.minus_words.size());
+    for (const std::string_view word : query.minus_words) {
+        const TermId term_id = terms_.Find(word);
+        if (term_id != TermDictionary::NO_TERM) {
+            terms.minus_terms.push_back(term_id);
+        }
+    }
+    std::sort(terms.minus_terms.begin(), terms.minus_terms.end());
+    return terms;
+}
+
+TermFrequencies SearchServer::GetDocumentTerms(int document_id) const {
+    const uint32_t internal_id = documents_.Find(document_id);
+    if (internal_id == DocumentTable::NO_DOCUMENT) {
+        throw std::out_of_range(" id  ");
+    }
+    return forward_index_.Get(internal_id);
+}
+
+vector<std::string_view> SearchServer::MatchDocumentTerms(const Query& query, const MatchTerms& terms,
+                                                          TermFrequencies document_terms) const {
+    // Query terms are sorted, so the search for each one starts where the previous one stopped
+    const auto has_term = [end = document_terms.end()](const TermFrequency*& it, TermId term_id) {
+        it = std::lower_bound(it, end, term_id,
+            [](const TermFrequency& item, TermId term_id) {
+                return item.term_id < term_id;
+            }
+        );
+        return it != end && it->term_id == term_id;
+    };
+
+    auto it = document_terms.begin();
+    for (const TermId term_id : terms.minus_terms) {
+        if (has_term(it, term_id)) {
+            return {};
+        }
+    }
+
+    // Positions in query.plus_words, which is sorted and has no repeats
+    std::pmr::vector<size_t> matched_positions(query.GetResource());
+    matched_positions.reserve(terms.plus_terms.size());
+    it = document_terms.begin();
+    for (const auto& [term_id, position] : terms.plus_terms) {
+        if (has_term(it, term_id)) {
+            matched_positions.push_back(position);
+        }
+    }
+    std::sort(matched_positions.begin(), matched_positions.end());
+
+    vector<std::string_view> matched_words;
+    matched_words.reserve(matched_positions.size());
+    for (const size_t position : matched_positions) {
+        matched_words.push_back(query.plus_words[position]);
+    }
+    return matched_words;
+}
+
+const SearchServer::TermData* SearchServer::FindTerm(std::string_view word) const {
+    const TermId term_id = terms_.Find(word);
+    return term_id == TermDictionary::NO_TERM ? nullptr : &term_data_[term_id];
+}
+
+std::pmr::vector<SearchServer::WordPostings> SearchServer::FindPlusWordPostings(const Query& query) const {
+    std::pmr::vector<WordPostings> result(query.GetResource());
+    result.reserve(query.plus_words.size());
+    for (const std::string_view word : query.plus_words) {
+        const auto* term = FindTerm(word);
+        if (term && GetPostingCount(*term) > 0) {
+            result.push_back({ term, query.inverse_document_freq
+                ? (*query.inverse_document_freq)(word)
+                : GetInverseDocumentFreq(*term) });
+        }
+    }
+    return result;
+}
+
+vector<SearchServer::PostingSlice> SearchServer::SplitIntoSlices(const vector<const TermData*>& terms) const {
+    static constexpr size_t SLICES_PER_THREAD = 4;
+    static constexpr size_t MIN_SLICE_LENGTH = 1024;
+    // Compressed lists are decoded by whole blocks
+    static constexpr size_t SLICE_ALIGNMENT = CompressedPostingList::BLOCK_SIZE;
+
+    size_t total_length = 0;
+    for (const auto* term : terms) {
+        total_length += GetStoredPostingCount(*term);
+    }
+    size_t slice_length = std::max(MIN_SLICE_LENGTH,
+        total_length / (thread_pool_->GetThreadCount() * SLICES_PER_THREAD));
+    slice_length = (slice_length + SLICE_ALIGNMENT - 1) / SLICE_ALIGNMENT * SLICE_ALIGNMENT;
+
+    vector<PostingSlice> slices;
+    for (size_t list_index = 0; list_index < terms.size(); ++list_index) {
+        const size_t list_length = GetStoredPostingCount(*terms[list_index]);
+        for (size_t first = 0; first < list_length; first += slice_length) {
+            slices.push_back({ list_index, first, std::min(first + slice_length, list_length) });
+        }
+    }
+    return slices;
+}
+
+size_t SearchServer::GetPostingCount(const TermData& term) const {
+    return posting_format_ == PostingFormat::PLAIN ? term.postings.size() : term.compressed_postings.size();
+}
+
+size_t SearchServer::GetStoredPostingCount(const TermData& term) const {
+    return posting_format_ == PostingFormat::PLAIN
+        ? term.postings.StoredCount()
+        : term.compressed_postings.StoredCount();
+}
+
+bool SearchServer::AcceptsDocument(const DocumentStatusFilter& document_filter, uint32_t internal_id) const {
+    const int rating = documents_.GetRating(internal_id);
+    return documents_.GetStatus(internal_id) == document_filter.status
+        && rating >= document_filter.ratings.min && rating <= document_filter.ratings.max;
+}
+
+bool SearchServer::HasPosting(const TermData& term, uint32_t internal_id) const {
+    return posting_format_ == PostingFormat::PLAIN
+        ? term.postings.Contains(internal_id)
+        : term.compressed_postings.Contains(internal_id);
+}
+
+void SearchServer::RemovePosting(TermData& term, uint32_t internal_id) {
+    if (posting_format_ == PostingFormat::PLAIN) {
+        term.postings.Remove(internal_id);
+    }
+    else {
+        term.compressed_postings.Remove(internal_id);
+    }
+}
+
+void SearchServer::RemovePostings(TermData& term, const vector<int>& internal_ids) {
+    if (posting_format_ == PostingFormat::PLAIN) {
+        term.postings.RemoveAll(internal_ids);
+    }
+    else {
+        term.compressed_postings.RemoveAll(internal_ids);
+    }
+}
+
+double SearchServer::ComputeTermFreq(uint32_t count, size_t word_count) {
+    const double inv_word_count = 1.0 / word_count;
+    double term_freq = inv_word_count;
+    for (uint32_t i = 1; i < count; ++i) {
+        term_freq += inv_word_count;
+    }
+    return term_freq;
+}
+
+uint32_t SearchServer::CountOccurrences(double term_freq, size_t word_count) {
+    return static_cast<uint32_t>(std::lround(term_freq * word_count));
+}
+
+double SearchServer::GetTermFreq(const PostingList::Cursor& cursor) const {
+    return cursor.GetTermFreq();
+}
+
+double SearchServer::GetTermFreq(const CompressedPostingList::Cursor& cursor) const {
+    return ComputeTermFreq(cursor.GetCount(), documents_.GetWordCount(cursor.GetDocumentId()));
+}
+
+void SearchServer::UpdateLogDocumentFreq(TermId term_id) {
+    auto& term = term_data_[term_id];
+    const size_t document_freq = GetPostingCount(term);
+    term.log_document_freq = document_freq == 0 ? 0.0 : log(document_freq);
+}
+
+void SearchServer::UpdateLogDocumentCount() {
+    log_document_count_ = documents_.empty() ? 0.0 : log(documents_.size());
+}
+
+double SearchServer::GetInverseDocumentFreq(const TermData& term) const {
+    // A term left without postings by removals has no documents to weigh
+    return GetPostingCount(term) == 0 ? 0.0 : log_document_count_ - term.log_document_freq;
 }
\ No newline at end of file
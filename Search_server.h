@@ -4,66 +4,107 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <unordered_map>
 #include <stdexcept>
 #include <algorithm>
 #include <execution>
 #include <utility>
 #include<string_view>
 #include<functional>
-#include<future>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <queue>
 
 #include "string_processing.h"
 #include "document.h"
-#include "concurrent_map.h"
+#include "document_table.h"
+#include "forward_index.h"
+#include "concurrent_accumulator.h"
+#include "posting_list.h"
+#include "compressed_posting_list.h"
+#include "term_dictionary.h"
+#include "top_documents.h"
+#include "thread_pool.h"
+#include "mapped_file.h"
+#include "query_result_cache.h"
+#include "query_arena.h"
+#include "search_metrics.h"
 
 using namespace std::string_literals;
 
 const int MAX_RESULT_DOCUMENT_COUNT = 5;
-const double eps = 1e-6;
+
+// How a SearchServer keeps posting lists: PLAIN stores (document id, term freq)
+// pairs, COMPRESSED packs document ids and occurrence counts into blocks
+enum class PostingFormat {
+    PLAIN,
+    COMPRESSED,
+};
 
 class SearchServer {
 
 public:
     SearchServer() = default;
 
+    // Parallel overloads run on thread_pool, which may be shared with other servers
     template <typename StringContainer>
-    explicit SearchServer(const StringContainer& stop_words);
+    explicit SearchServer(const StringContainer& stop_words,
+        std::shared_ptr<ThreadPool> thread_pool = ThreadPool::GetDefault(),
+        PostingFormat posting_format = PostingFormat::PLAIN);
+
+    explicit SearchServer(const std::string& stop_words_text,
+        std::shared_ptr<ThreadPool> thread_pool = ThreadPool::GetDefault(),
+        PostingFormat posting_format = PostingFormat::PLAIN);
+
+    // Move-only: the term dictionary keeps its words in chunks it owns alone, and the result
+    // cache would be shared by a copy. Not assignable either, as the stop words are const
+    SearchServer(const SearchServer&) = delete;
+    SearchServer& operator=(const SearchServer&) = delete;
+    SearchServer(SearchServer&&) = default;
 
-    explicit SearchServer(const std::string& stop_words_text);
+    ThreadPool& GetThreadPool() const;
 
-    std::set<int>::const_iterator begin() const;
+    DocumentTable::ConstIterator begin() const;
 
-    std::set<int>::const_iterator end() const;
+    DocumentTable::ConstIterator end() const;
 
     void AddDocument(int document_id, const std::string_view& document,
         DocumentStatus status, const std::vector<int>& ratings);
 
+    // Tokenizes the documents in parallel and merges them into the index at once.
+    // A document with an invalid id or word is skipped and reported, the rest are added
+    std::vector<DocumentError> AddDocuments(const std::vector<DocumentInput>& documents);
+
+    // max_result_count limits how many of the most relevant documents are returned
     template <typename DocumentPredicate>
     std::vector<Document> FindTopDocuments(const std::string_view raw_query,
-        DocumentPredicate document_predicate) const;
+        DocumentPredicate document_predicate, size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
 
     std::vector<Document> FindTopDocuments(const std::string_view raw_query,
-        DocumentStatus status) const;
+        DocumentStatus status, size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
 
     std::vector<Document> FindTopDocuments(const std::string_view raw_query) const;
 
     template <typename DocumentPredicate>
     std::vector<Document> FindTopDocuments(const std::execution::parallel_policy&,
         const std::string_view raw_query,
-        DocumentPredicate document_predicate) const;
+        DocumentPredicate document_predicate, size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
 
     template <typename DocumentPredicate>
     std::vector<Document> FindTopDocuments(const std::execution::sequenced_policy&,
         const std::string_view raw_query,
-        DocumentPredicate document_predicate) const;
+        DocumentPredicate document_predicate, size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
 
     std::vector<Document> FindTopDocuments(const std::execution::parallel_policy&,
         const std::string_view raw_query,
-        DocumentStatus status) const;
+        DocumentStatus status, size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
 
     std::vector<Document> FindTopDocuments(const std::execution::sequenced_policy&,
         const std::string_view raw_query,
-        DocumentStatus status) const;
+        DocumentStatus status, size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
 
     std::vector<Document> FindTopDocuments(const std::execution::parallel_policy&,
         const std::string_view raw_query) const;
@@ -71,58 +112,315 @@ public:
     std::vector<Document> FindTopDocuments(const std::execution::sequenced_policy&,
         const std::string_view raw_query) const;
 
+    // Status and rating filters read the status and rating columns of the document table
+    // for every candidate; no separate status or rating index is kept
+    std::vector<Document> FindTopDocuments(const std::string_view raw_query,
+        DocumentStatus status, RatingRange ratings, size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    std::vector<Document> FindTopDocuments(const std::execution::parallel_policy&,
+        const std::string_view raw_query,
+        DocumentStatus status, RatingRange ratings, size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    std::vector<Document> FindTopDocuments(const std::execution::sequenced_policy&,
+        const std::string_view raw_query,
+        DocumentStatus status, RatingRange ratings, size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    // FindTopDocuments(raw_query, status, max_result_count) for every query of the batch.
+    // Words are looked up once per batch, and queries are scored on the thread pool
+    // ordered by their longest posting list, so queries reading the same list run together
+    QueryBatchResults FindTopDocumentsBatch(const std::vector<std::string>& raw_queries,
+        DocumentStatus status = DocumentStatus::ACTUAL, size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    // Weight of a plus word in relevance, for a server that holds a part of a larger index
+    using InverseDocumentFreq = std::function<double(std::string_view word)>;
+
+    // Weighs plus words by inverse_document_freq instead of the statistics of this server
+    template <typename DocumentPredicate>
+    std::vector<Document> FindTopDocuments(const std::execution::sequenced_policy&,
+        const std::string_view raw_query, DocumentPredicate document_predicate,
+        const InverseDocumentFreq& inverse_document_freq, size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
+
     int GetDocumentCount() const;
 
+    // Documents the word occurs in
+    size_t GetDocumentFreq(std::string_view word) const;
+
+    // Adds the documents of other accepted by document_predicate(document_id, status, rating),
+    // with their ratings and term freqs. Both servers must have the same stop words.
+    // Throws std::invalid_argument and adds nothing if this server has one of the documents already
+    template <typename DocumentPredicate>
+    void AddDocumentsFrom(const SearchServer& other, DocumentPredicate document_predicate);
+
+    // A single document is matched in one pass whatever the policy
     template<typename ExecutionPolicy>
     std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(
         ExecutionPolicy&& policy, const std::string_view raw_query, int document_id) const;
 
+    // Plus words of the query that the document has, sorted, or none if it has a minus word.
+    // The words are looked up once and merged with the sorted terms of the document.
+    // Throws std::out_of_range if there is no such document
     std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(
         const std::string_view raw_query, int document_id) const;
 
-    const std::map<std::string_view, double>& GetWordFrequencies(int document_id) const;
+    // MatchDocument for every document: the query is parsed once and the documents
+    // are matched in parallel. Throws std::out_of_range if one of them does not exist
+    std::vector<std::tuple<std::vector<std::string_view>, DocumentStatus>> MatchDocuments(
+        const std::string_view raw_query, const std::vector<int>& document_ids) const;
+
+    // Terms of the document sorted by term id, empty if there is no such document.
+    // The view is valid until the next change of the server
+    TermFrequencies GetWordFrequencies(int document_id) const;
+
+    std::string_view GetWord(TermId term_id) const;
+
+    // Bytes taken by the posting lists of all terms
+    size_t GetPostingsMemoryUsage() const;
+
+    // With dynamic pruning, which is on by default, the sequential FindTopDocuments
+    // skips documents that cannot make it into the top, with the same results
+    void SetDynamicPruning(bool enabled);
+
+    // Postings whose score queries have computed since the server was created
+    size_t GetScoredPostingCount() const;
+
+    // Keeps up to capacity results of the status and rating overloads of FindTopDocuments,
+    // keyed by the parsed query, until a document is added or removed. 0 turns the cache off,
+    // which is the default. Queries with other predicates are never cached
+    void SetResultCacheCapacity(size_t capacity);
+
+    QueryResultCacheStats GetResultCacheStats() const;
 
     template <typename ExecutionPolicy>
     void RemoveDocument(ExecutionPolicy&& policy, int document_id);
 
     void RemoveDocument(int document_id);
 
+    // Removes many documents at once: their postings are grouped by term, so every
+    // posting list is rewritten once, and the terms are processed in parallel.
+    // Ids of unknown documents are ignored
+    void RemoveDocuments(const std::vector<int>& document_ids);
+
+    // Writes the whole index to a versioned binary file with a checksum
+    void SaveSnapshot(const std::string& path) const;
+
+    // Maps a file written by SaveSnapshot. Posting lists and words are used
+    // in place, so the inverted index is not rebuilt and their pages are shared
+    // by every process that loads the same file. Loading is not free of copies:
+    // the checksum of the whole file and every posting are checked, and the
+    // documents and the forward index are copied out of the file, so it takes
+    // time linear in the size of the index. The loaded server uses PostingFormat::PLAIN.
+    // Throws std::runtime_error if the file is damaged or has another version
+    static SearchServer LoadSnapshot(const std::string& path,
+        std::shared_ptr<ThreadPool> thread_pool = ThreadPool::GetDefault());
+
 private:
-    struct DocumentData {
-        int rating;
-        DocumentStatus status;
+    const std::set<std::string, std::less<>> stop_words_;
+    std::shared_ptr<ThreadPool> thread_pool_ = ThreadPool::GetDefault();
+    PostingFormat posting_format_ = PostingFormat::PLAIN;
+    bool dynamic_pruning_ = true;
+    // Shared, so that the server stays movable
+    std::shared_ptr<std::atomic<size_t>> scored_posting_count_ = std::make_shared<std::atomic<size_t>>(0);
+    std::shared_ptr<QueryResultCache> result_cache_;
+    // Changes with every added or removed document, so cached results of older generations are stale
+    uint64_t generation_ = 0;
+    // Snapshot the postings and words were loaded from, if any
+    std::shared_ptr<const MappedFile> snapshot_file_;
+    TermDictionary terms_;
+    struct TermData {
+        // Only the list of posting_format_ is used. Postings refer to documents by internal id
+        PostingList postings;
+        CompressedPostingList compressed_postings;
+        // log(postings.size()): IDF is log_document_count_ - log_document_freq,
+        // so a change of the document count does not touch every term
+        double log_document_freq = 0.0;
+        // Bounds the score of the term in any document, removals may leave it too high
+        double max_term_freq = 0.0;
     };
 
-    const std::set<std::string, std::less<>> stop_words_;
-    std::map<std::string, std::map<int, double>> word_to_document_freqs_;
-    std::map<int, DocumentData> documents_;
-    std::set<int> document_ids_;
-    std::map<int, std::map<std::string_view, double>> document_to_word_freqs_;
+    std::vector<TermData> term_data_;
+    double log_document_count_ = 0.0;
+    // Internal ids are renumbered once removals leave most of them unused, so per-document
+    // arrays indexed by them, such as ConcurrentAccumulator, stay proportional to the documents
+    DocumentTable documents_;
+    // Terms of every document by internal id
+    ForwardIndex forward_index_;
 
     bool IsStopWord(const std::string_view& word) const;
 
     static bool IsValidWord(const std::string_view& word);
 
-    std::vector<std::string_view> SplitIntoWordsNoStop(const std::string_view& text) const;
+    // Replaces the contents of words with the words of text that are not stop words
+    void SplitIntoWordsNoStop(std::string_view text, std::vector<std::string_view>& words) const;
 
     static int ComputeAverageRating(const std::vector<int>& ratings);
 
+    // Index of a block of an AddDocuments batch, with words numbered within the block
+    struct PartialIndex {
+        std::vector<std::string_view> words;
+        std::unordered_map<std::string_view, TermId> word_ids;
+        // Documents are numbered by their position in the batch
+        std::vector<std::vector<Posting>> word_postings;
+        // (local word id, term freq) of every document of the block, empty for failed ones
+        std::vector<std::vector<std::pair<TermId, double>>> document_word_freqs;
+        std::vector<size_t> document_word_counts;
+    };
+
+    // Adds the documents of other with the given internal ids
+    void CopyDocuments(const SearchServer& other, const std::vector<uint32_t>& internal_ids);
+
+    // Indexes documents [first, last) of the batch, recording errors in error_messages
+    PartialIndex BuildPartialIndex(const std::vector<DocumentInput>& documents,
+        size_t first, size_t last, std::vector<std::string>& error_messages) const;
+
     struct QueryWord {
         std::string_view data;
         bool is_minus;
         bool is_stop;
     };
 
-    QueryWord ParseQueryWord(const std::string_view& text) const;
+    // The word is checked for control characters only if may_be_invalid
+    QueryWord ParseQueryWord(const std::string_view& text, bool may_be_invalid = true) const;
 
+    // Words are sorted and unique. The other temporaries of the query
+    // take their memory from the same resource as the words
     struct Query {
-        std::set<std::string_view, std::less<>> plus_words;
-        std::set<std::string_view, std::less<>> minus_words;
+        std::pmr::vector<std::string_view> plus_words;
+        std::pmr::vector<std::string_view> minus_words;
+        // Replaces GetInverseDocumentFreq if set
+        const InverseDocumentFreq* inverse_document_freq = nullptr;
+
+        std::pmr::memory_resource* GetResource() const {
+            return plus_words.get_allocator().resource();
+        }
     };
 
-    Query ParseQuery(const std::string_view& text) const;
+    Query ParseQuery(const std::string_view& text,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+    // Words of a query that are in the index, sorted by term id for a merge with the terms of a document
+    struct MatchTerms {
+        // With the position of the word in Query::plus_words
+        std::pmr::vector<std::pair<TermId, size_t>> plus_terms;
+        std::pmr::vector<TermId> minus_terms;
+    };
+
+    MatchTerms FindMatchTerms(const Query& query) const;
+
+    // Throws std::out_of_range if there is no such document
+    TermFrequencies GetDocumentTerms(int document_id) const;
+
+    std::vector<std::string_view> MatchDocumentTerms(const Query& query, const MatchTerms& terms,
+        TermFrequencies document_terms) const;
 
-    double ComputeWordInverseDocumentFreq(const std::string_view& word) const;
+    // Plus words, minus words and the filter, so that equal queries have equal keys
+    static std::string MakeResultCacheKey(const Query& query, DocumentStatus status,
+        const std::optional<RatingRange>& ratings, size_t max_result_count);
+
+    template <typename DocumentPredicate>
+    std::vector<Document> FindTopDocuments(const std::execution::sequenced_policy&, const Query& query,
+        DocumentPredicate document_predicate, size_t max_result_count) const;
+
+    template <typename DocumentPredicate>
+    std::vector<Document> FindTopDocuments(const std::execution::parallel_policy&, const Query& query,
+        DocumentPredicate document_predicate, size_t max_result_count) const;
+
+    // Searches documents with the status and, if given, a rating in ratings, through the result cache
+    template <typename ExecutionPolicy>
+    std::vector<Document> FindTopFilteredDocuments(const ExecutionPolicy& policy, const std::string_view raw_query,
+        DocumentStatus status, const std::optional<RatingRange>& ratings, size_t max_result_count) const;
+
+    struct WordPostings {
+        const TermData* term;
+        double inverse_document_freq;
+    };
+
+    const TermData* FindTerm(std::string_view word) const;
+
+    // Looks up every plus word once, skipping words that have no postings
+    std::pmr::vector<WordPostings> FindPlusWordPostings(const Query& query) const;
+
+    struct PostingSlice {
+        size_t list_index;
+        size_t first;
+        size_t last;
+    };
+
+    // Cuts posting lists into slices of similar length, so that the tasks of
+    // a parallel pass are balanced however long the individual lists are
+    std::vector<PostingSlice> SplitIntoSlices(const std::vector<const TermData*>& terms) const;
+
+    // Predicate of the status and rating filters, checked against the columns of the document table
+    struct DocumentStatusFilter {
+        DocumentStatus status;
+        RatingRange ratings;
+    };
+
+    template <typename DocumentPredicate>
+    bool AcceptsDocument(const DocumentPredicate& document_predicate, uint32_t internal_id) const;
+
+    bool AcceptsDocument(const DocumentStatusFilter& document_filter, uint32_t internal_id) const;
+
+    // Calls function(internal_id, term_freq) for the postings of term
+    // stored at positions [first, last), whatever the posting format
+    template <typename Function>
+    void ForEachPosting(const TermData& term, size_t first, size_t last, Function function) const;
+
+    // Same as ForEachPosting, but gives only internal ids
+    template <typename Function>
+    void ForEachInternalId(const TermData& term, size_t first, size_t last, Function function) const;
+
+    size_t GetPostingCount(const TermData& term) const;
+
+    // Postings up to the end of the storage, including removed ones
+    size_t GetStoredPostingCount(const TermData& term) const;
+
+    bool HasPosting(const TermData& term, uint32_t internal_id) const;
+
+    void RemovePosting(TermData& term, uint32_t internal_id);
+
+    // internal_ids must be sorted
+    void RemovePostings(TermData& term, const std::vector<int>& internal_ids);
+
+    // Term freq of a word met count times among word_count words, summed
+    // the way AddDocument sums it, so both posting formats give equal relevance
+    static double ComputeTermFreq(uint32_t count, size_t word_count);
+
+    static uint32_t CountOccurrences(double term_freq, size_t word_count);
+
+    template <typename Cursor>
+    static Cursor MakeCursor(const TermData& term);
+
+    double GetTermFreq(const PostingList::Cursor& cursor) const;
+
+    double GetTermFreq(const CompressedPostingList::Cursor& cursor) const;
+
+    // Scores documents one at a time, walking the posting lists together. A document
+    // with a minus word is skipped by galloping through the minus lists before it is
+    // shown to the predicate.
+    // Given top_count, lists are ordered by the largest score they can add (MaxScore):
+    // a document found only in lists that together cannot lift it into the top top_count
+    // is skipped, and so is a document whose score stops being able to get there.
+    // Returns the scored documents in internal id order; the top ones are among them
+    template <typename Cursor, typename DocumentPredicate>
+    std::pmr::vector<Document> FindDocumentsAtATime(const Query& query,
+        DocumentPredicate document_predicate, std::optional<size_t> top_count) const;
+
+    // Same, for plus and minus words that are looked up already. The result
+    // and the temporaries take their memory from resource
+    template <typename Cursor, typename DocumentPredicate>
+    std::pmr::vector<Document> FindDocumentsAtATime(const std::pmr::vector<WordPostings>& plus_word_postings,
+        const std::pmr::vector<const TermData*>& minus_terms, DocumentPredicate document_predicate,
+        std::optional<size_t> top_count, std::pmr::memory_resource* resource) const;
+
+    void UpdateLogDocumentFreq(TermId term_id);
+
+    void UpdateLogDocumentCount();
+
+    // Renumbers the documents in the table, the forward index and every posting list
+    // once more than half of the internal ids are unused. The order of documents is kept
+    void CompactInternalIds();
+
+    double GetInverseDocumentFreq(const TermData& term) const;
 
     template <typename DocumentPredicate>
     std::vector<Document> FindAllDocuments(const Query& query, 
@@ -139,8 +437,11 @@ private:
 
 
 template <typename StringContainer>
-SearchServer::SearchServer(const StringContainer& stop_words)
+SearchServer::SearchServer(const StringContainer& stop_words, std::shared_ptr<ThreadPool> thread_pool,
+                           PostingFormat posting_format)
     : stop_words_(MakeUniqueNonEmptyStrings(stop_words))  // Extract non-empty stop words
+    , thread_pool_(std::move(thread_pool))
+    , posting_format_(posting_format)
 {
     if (!std::all_of(stop_words_.begin(), stop_words_.end(), IsValidWord)) {
         throw std::invalid_argument("Some of stop words are invalid"s);
@@ -149,54 +450,100 @@ SearchServer::SearchServer(const StringContainer& stop_words)
 
 template <typename DocumentPredicate>
 std::vector<Document> SearchServer::FindTopDocuments(const std::execution::sequenced_policy&, 
-                const std::string_view raw_query, DocumentPredicate document_predicate) const {
-    const auto query = ParseQuery(raw_query);
+                const std::string_view raw_query, DocumentPredicate document_predicate,
+                size_t max_result_count) const {
+    METRICS_STAGE(FIND_TOP_DOCUMENTS);
+    QueryArena arena;
+    return FindTopDocuments(std::execution::seq, ParseQuery(raw_query, arena.GetResource()),
+        document_predicate, max_result_count);
+}
 
-    auto matched_documents = FindAllDocuments(query, document_predicate);
+template <typename DocumentPredicate>
+std::vector<Document> SearchServer::FindTopDocuments(const std::execution::sequenced_policy&,
+                const Query& query, DocumentPredicate document_predicate, size_t max_result_count) const {
+    std::optional<size_t> top_count;
+    if (dynamic_pruning_) {
+        top_count = max_result_count;
+    }
+    auto matched_documents = posting_format_ == PostingFormat::PLAIN
+        ? FindDocumentsAtATime<PostingList::Cursor>(query, document_predicate, top_count)
+        : FindDocumentsAtATime<CompressedPostingList::Cursor>(query, document_predicate, top_count);
+    {
+        METRICS_STAGE(TOP_SELECTION);
+        SelectTopDocuments(std::execution::seq, matched_documents, max_result_count);
+    }
+    METRICS_STAGE(RESULT_BUILDING);
+    return std::vector<Document>(matched_documents.begin(), matched_documents.end());
+}
 
-    sort(std::execution::seq, matched_documents.begin(), matched_documents.end(),
-        [](const Document& lhs, const Document& rhs) {
-            if (std::abs(lhs.relevance - rhs.relevance) < eps) {
-                return lhs.rating > rhs.rating;
-            }
-            else {
-                return lhs.relevance > rhs.relevance;
-            }
-        }
-    );
+template <typename DocumentPredicate>
+std::vector<Document> SearchServer::FindTopDocuments(const std::execution::sequenced_policy&,
+                const std::string_view raw_query, DocumentPredicate document_predicate,
+                const InverseDocumentFreq& inverse_document_freq, size_t max_result_count) const {
+    METRICS_STAGE(FIND_TOP_DOCUMENTS);
+    QueryArena arena;
+    auto query = ParseQuery(raw_query, arena.GetResource());
+    query.inverse_document_freq = &inverse_document_freq;
+    return FindTopDocuments(std::execution::seq, query, document_predicate, max_result_count);
+}
 
-    if (matched_documents.size() > MAX_RESULT_DOCUMENT_COUNT) {
-        matched_documents.resize(MAX_RESULT_DOCUMENT_COUNT);
+template <typename DocumentPredicate>
+void SearchServer::AddDocumentsFrom(const SearchServer& other, DocumentPredicate document_predicate) {
+    std::vector<uint32_t> internal_ids;
+    internal_ids.reserve(other.documents_.size());
+    for (uint32_t internal_id = 0; internal_id < other.documents_.GetInternalIdBound(); ++internal_id) {
+        if (other.documents_.IsUsed(internal_id) && other.AcceptsDocument(document_predicate, internal_id)) {
+            internal_ids.push_back(internal_id);
+        }
     }
-    return matched_documents;
+    CopyDocuments(other, internal_ids);
 }
 
 template <typename DocumentPredicate>
 std::vector<Document> SearchServer::FindTopDocuments(
-        const std::string_view raw_query, DocumentPredicate document_predicate) const {
-    return SearchServer::FindTopDocuments(std::execution::seq, raw_query, document_predicate);
+        const std::string_view raw_query, DocumentPredicate document_predicate,
+        size_t max_result_count) const {
+    return SearchServer::FindTopDocuments(std::execution::seq, raw_query, document_predicate, max_result_count);
 }
 
 template <typename DocumentPredicate>
 std::vector<Document> SearchServer::FindTopDocuments(const std::execution::parallel_policy&, 
-                const std::string_view raw_query, DocumentPredicate document_predicate) const {
-    const auto query = ParseQuery(raw_query);
+                const std::string_view raw_query, DocumentPredicate document_predicate,
+                size_t max_result_count) const {
+    METRICS_STAGE(FIND_TOP_DOCUMENTS);
+    QueryArena arena;
+    return FindTopDocuments(std::execution::par, ParseQuery(raw_query, arena.GetResource()),
+        document_predicate, max_result_count);
+}
 
+template <typename DocumentPredicate>
+std::vector<Document> SearchServer::FindTopDocuments(const std::execution::parallel_policy&,
+                const Query& query, DocumentPredicate document_predicate, size_t max_result_count) const {
     auto matched_documents = FindAllDocuments(std::execution::par, query, document_predicate);
+    METRICS_STAGE(TOP_SELECTION);
+    SelectTopDocuments(*thread_pool_, matched_documents, max_result_count);
+    return matched_documents;
+}
 
-    sort(std::execution::par, matched_documents.begin(), matched_documents.end(),
-        [](const Document& lhs, const Document& rhs) {
-            if (std::abs(lhs.relevance - rhs.relevance) < eps) {
-                return lhs.rating > rhs.rating;
-            }
-            else {
-                return lhs.relevance > rhs.relevance;
-            }
+template <typename ExecutionPolicy>
+std::vector<Document> SearchServer::FindTopFilteredDocuments(const ExecutionPolicy& policy,
+                const std::string_view raw_query, DocumentStatus status,
+                const std::optional<RatingRange>& ratings, size_t max_result_count) const {
+    METRICS_STAGE(FIND_TOP_DOCUMENTS);
+    QueryArena arena;
+    const auto query = ParseQuery(raw_query, arena.GetResource());
+    std::string key;
+    if (result_cache_) {
+        key = MakeResultCacheKey(query, status, ratings, max_result_count);
+        if (auto cached_documents = result_cache_->Find(key, generation_)) {
+            return std::move(*cached_documents);
         }
-    );
+    }
 
-    if (matched_documents.size() > MAX_RESULT_DOCUMENT_COUNT) {
-        matched_documents.resize(MAX_RESULT_DOCUMENT_COUNT);
+    auto matched_documents = FindTopDocuments(policy, query,
+        DocumentStatusFilter{ status, ratings.value_or(RatingRange{}) }, max_result_count);
+    if (result_cache_) {
+        result_cache_->Insert(std::move(key), generation_, matched_documents);
     }
     return matched_documents;
 }
@@ -211,152 +558,377 @@ std::vector<Document> SearchServer::FindAllDocuments(
 template <typename DocumentPredicate>
 std::vector<Document> SearchServer::FindAllDocuments(const std::execution::sequenced_policy&,
                                 const Query& query, DocumentPredicate document_predicate) const {
-    std::map<int, double> document_to_relevance;
-
-    for_each(query.plus_words.begin(), query.plus_words.end(),
-        [this, &document_predicate, &document_to_relevance](const std::string_view& word) {
-            if (word_to_document_freqs_.count(std::string(word)) != 0) {
-                const double inverse_document_freq = ComputeWordInverseDocumentFreq(word);
-                for (const auto [document_id, term_freq] : word_to_document_freqs_.at(std::string(word))) {
-                    const auto& document_data = documents_.at(document_id);
-                    if (document_predicate(document_id, document_data.status, document_data.rating)) {
-                        document_to_relevance[document_id] += term_freq * inverse_document_freq;
-                    }
-                }
-            }
-        }
-    );
-    for_each(query.minus_words.begin(), query.minus_words.end(),
-        [this, &document_to_relevance](const std::string_view& word) {
-            if (word_to_document_freqs_.count(std::string(word)) != 0) {
-                for (const auto [document_id, _] : word_to_document_freqs_.at(std::string(word))) {
-                    document_to_relevance.erase(document_id);
-                }
-            }
-        }
-    );
-    std::vector<Document> matched_documents;
-    for (const auto [document_id, relevance] : document_to_relevance) {
-        matched_documents.push_back({ document_id, relevance, documents_.at(document_id).rating });
-    }
-
-    return matched_documents;
+    const auto matched_documents = posting_format_ == PostingFormat::PLAIN
+        ? FindDocumentsAtATime<PostingList::Cursor>(query, document_predicate, std::nullopt)
+        : FindDocumentsAtATime<CompressedPostingList::Cursor>(query, document_predicate, std::nullopt);
+    return std::vector<Document>(matched_documents.begin(), matched_documents.end());
 }
 
 template <typename DocumentPredicate>
 std::vector<Document> SearchServer::FindAllDocuments(const std::execution::parallel_policy&,
                              const Query& query, DocumentPredicate document_predicate) const {
-    static constexpr int MINUS_LOCK_COUNT = 8;
-    ConcurrentMap<int, int> minus_ids(MINUS_LOCK_COUNT);
-    for_each(
-        std::execution::par,
-        query.minus_words.begin(),
-        query.minus_words.end(),
-        [this, &minus_ids](const std::string_view word) {
-            if (word_to_document_freqs_.count(std::string(word))) {
-                for (const auto& document_freqs : word_to_document_freqs_.at(std::string(word))) {
-                    minus_ids[document_freqs.first];
-                }
+    // A query that walks fewer postings than this share of the documents collects the internal ids
+    // it touches and reads and resets only them, a broader one scans the whole accumulator
+    static constexpr size_t SPARSE_POSTING_SHARE = 8;
+    const size_t internal_id_bound = documents_.GetInternalIdBound();
+    ThreadLocalAccumulator<double> accumulator(internal_id_bound);
+    auto& document_to_relevance = accumulator.Get();
+    // Internal ids each task touched first, collected only if the query is sparse
+    std::vector<std::vector<uint32_t>> minus_touched_ids;
+    std::vector<std::vector<uint32_t>> plus_touched_ids;
+    bool is_sparse = false;
+
+    std::vector<const TermData*> minus_terms;
+    std::pmr::vector<WordPostings> plus_word_postings(query.GetResource());
+    std::vector<const TermData*> plus_terms;
+    {
+        METRICS_STAGE(POSTING_FETCH);
+        for (const std::string_view word : query.minus_words) {
+            if (const auto* term = FindTerm(word)) {
+                minus_terms.push_back(term);
             }
         }
-    );
+        plus_word_postings = FindPlusWordPostings(query);
+        plus_terms.reserve(plus_word_postings.size());
+        for (const auto& word_postings : plus_word_postings) {
+            plus_terms.push_back(word_postings.term);
+        }
+        size_t posting_count = 0;
+        for (const auto* terms : { &minus_terms, &plus_terms }) {
+            for (const TermData* term : *terms) {
+                posting_count += GetStoredPostingCount(*term);
+            }
+        }
+        is_sparse = posting_count * SPARSE_POSTING_SHARE < internal_id_bound;
+    }
 
-    auto minus = minus_ids.BuildOrdinaryMap();
-
-    static constexpr int PLUS_LOCK_COUNT = 100;
-    ConcurrentMap<int, double> document_to_relevance(PLUS_LOCK_COUNT);
-    static constexpr int PART_COUNT = 4;
-    const auto part_length = query.plus_words.size() / PART_COUNT;
-    auto part_begin = query.plus_words.begin();
-    auto part_end = next(part_begin, part_length);
-
-    std::vector<std::future<void>> futures;
-    for (int i = 0; i < PART_COUNT;
-        ++i, part_begin = part_end, part_end = (i == PART_COUNT - 1 ? query.plus_words.end() : next(part_begin, part_length))) {
-        futures.push_back(std::async(
-            [this, part_begin, part_end, &document_predicate, &document_to_relevance, &minus] {
-                for_each(std::execution::par, part_begin, part_end, 
-                    [this, &document_predicate, &document_to_relevance, &minus](std::string_view word) {
-                        if (word_to_document_freqs_.count(std::string(word))) {
-                            const double inverse_document_freq = ComputeWordInverseDocumentFreq(word);
-                            for (const auto [document_id, term_freq] : word_to_document_freqs_.at(std::string(word))) {
-                                const auto& document_data = documents_.at(document_id);
-                                if (document_predicate(document_id, document_data.status, document_data.rating)
-                                                                                && (minus.count(document_id) == 0)) {
-                                    document_to_relevance[document_id].ref_to_value += term_freq * inverse_document_freq;
-                                }
-                            }
+    {
+        METRICS_STAGE(MINUS_FILTERING);
+        const auto minus_slices = SplitIntoSlices(minus_terms);
+        minus_touched_ids.resize(minus_slices.size());
+        thread_pool_->ParallelFor(minus_slices.size(),
+            [this, &minus_slices, &minus_terms, &document_to_relevance, &minus_touched_ids, is_sparse](size_t slice_index) {
+                const auto [list_index, first, last] = minus_slices[slice_index];
+                auto& touched_ids = minus_touched_ids[slice_index];
+                ForEachInternalId(*minus_terms[list_index], first, last,
+                    [&document_to_relevance, &touched_ids, is_sparse](uint32_t internal_id) {
+                        if (document_to_relevance.Exclude(internal_id) && is_sparse) {
+                            touched_ids.push_back(internal_id);
                         }
                     }
                 );
-            })
+            }
         );
     }
 
-    for (auto& stage : futures) {
-        stage.get();
+    {
+        METRICS_STAGE(SCORING);
+        size_t scored_posting_count = 0;
+        for (const TermData* term : plus_terms) {
+            scored_posting_count += GetPostingCount(*term);
+        }
+        *scored_posting_count_ += scored_posting_count;
+        METRICS_COUNT(SCORED_POSTINGS, scored_posting_count);
+        const auto plus_slices = SplitIntoSlices(plus_terms);
+        plus_touched_ids.resize(plus_slices.size());
+        thread_pool_->ParallelFor(plus_slices.size(),
+            [this, &plus_slices, &plus_word_postings, &document_predicate, &document_to_relevance, &plus_touched_ids,
+                is_sparse](size_t slice_index) {
+                const auto [list_index, first, last] = plus_slices[slice_index];
+                const auto [term, inverse_document_freq] = plus_word_postings[list_index];
+                auto& touched_ids = plus_touched_ids[slice_index];
+                ForEachPosting(*term, first, last,
+                    [this, &document_predicate, &document_to_relevance, &touched_ids, is_sparse,
+                        inverse_document_freq = inverse_document_freq](uint32_t internal_id, double term_freq) {
+                        // Minus words are all excluded by now, so their documents skip the predicate
+                        if (!document_to_relevance.IsExcluded(internal_id) && AcceptsDocument(document_predicate, internal_id)
+                            && document_to_relevance.Add(internal_id, term_freq * inverse_document_freq) && is_sparse) {
+                            touched_ids.push_back(internal_id);
+                        }
+                    }
+                );
+            }
+        );
     }
 
+    METRICS_STAGE(RESULT_BUILDING);
     std::vector<Document> matched_documents;
-    for (const auto [document_id, relevance] : document_to_relevance.BuildOrdinaryMap()) {
-        matched_documents.push_back({ document_id, relevance, documents_.at(document_id).rating });
+    const auto add_document = [this, &matched_documents](size_t internal_id, double relevance) {
+        matched_documents.push_back({ documents_.GetDocumentId(internal_id), relevance, documents_.GetRating(internal_id) });
+    };
+    if (is_sparse) {
+        std::vector<uint32_t> touched_ids;
+        for (const auto* task_touched_ids : { &minus_touched_ids, &plus_touched_ids }) {
+            for (const auto& ids : *task_touched_ids) {
+                touched_ids.insert(touched_ids.end(), ids.begin(), ids.end());
+            }
+        }
+        // In internal id order, as the scan of the whole accumulator gives them
+        std::sort(touched_ids.begin(), touched_ids.end());
+        document_to_relevance.ForEach(touched_ids, add_document);
+        document_to_relevance.Reset(touched_ids);
     }
+    else {
+        document_to_relevance.ForEachAndResetAll(add_document);
+    }
+    accumulator.MarkClean();
     return matched_documents;
 }
 
-template<typename ExecutionPolicy>
-void SearchServer::RemoveDocument(ExecutionPolicy&& policy, int document_id) {
-    if (!document_ids_.count(document_id)) {
-        return;
+template <typename Cursor, typename DocumentPredicate>
+std::pmr::vector<Document> SearchServer::FindDocumentsAtATime(const Query& query,
+                             DocumentPredicate document_predicate, std::optional<size_t> top_count) const {
+    std::pmr::memory_resource* resource = query.GetResource();
+    if (top_count == 0) {
+        return std::pmr::vector<Document>(resource);
+    }
+    std::pmr::vector<const TermData*> minus_terms(resource);
+    std::pmr::vector<WordPostings> plus_word_postings(resource);
+    {
+        METRICS_STAGE(POSTING_FETCH);
+        minus_terms.reserve(query.minus_words.size());
+        for (const std::string_view word : query.minus_words) {
+            if (const auto* term = FindTerm(word)) {
+                minus_terms.push_back(term);
+            }
+        }
+        plus_word_postings = FindPlusWordPostings(query);
+    }
+    return FindDocumentsAtATime<Cursor>(plus_word_postings, minus_terms, document_predicate, top_count, resource);
+}
+
+template <typename Cursor, typename DocumentPredicate>
+std::pmr::vector<Document> SearchServer::FindDocumentsAtATime(const std::pmr::vector<WordPostings>& plus_word_postings,
+                             const std::pmr::vector<const TermData*>& minus_terms, DocumentPredicate document_predicate,
+                             std::optional<size_t> top_count, std::pmr::memory_resource* resource) const {
+    if (top_count == 0) {
+        return std::pmr::vector<Document>(resource);
+    }
+    METRICS_STAGE(SCORING);
+    struct TermCursor {
+        Cursor cursor;
+        double inverse_document_freq;
+        double max_score;
+        // Scores are summed in the order of the plus words, whatever order MaxScore visits the terms in,
+        // so searches with and without pruning give the same sums
+        size_t word_index;
+    };
+    std::pmr::vector<TermCursor> terms(resource);
+    terms.reserve(plus_word_postings.size());
+    for (size_t word_index = 0; word_index < plus_word_postings.size(); ++word_index) {
+        const auto [term, inverse_document_freq] = plus_word_postings[word_index];
+        terms.push_back({ MakeCursor<Cursor>(*term), inverse_document_freq,
+            term->max_term_freq * inverse_document_freq, word_index });
+    }
+    if (top_count) {
+        std::sort(terms.begin(), terms.end(),
+            [](const TermCursor& lhs, const TermCursor& rhs) {
+                return lhs.max_score < rhs.max_score;
+            }
+        );
+    }
+    // The most terms [0, i] can add to a score together
+    std::pmr::vector<double> max_score_sums(terms.size(), resource);
+    double max_score_sum = 0.0;
+    for (size_t i = 0; i < terms.size(); ++i) {
+        max_score_sum += terms[i].max_score;
+        max_score_sums[i] = max_score_sum;
     }
-    auto& items = document_to_word_freqs_.at(document_id);
-    std::vector<std::string_view> ptrs_on_words(items.size());
 
-    std::transform(policy, items.begin(), items.end(), ptrs_on_words.begin(),
-        [](const auto& item) { 
-            return item.first; 
+    std::pmr::vector<Cursor> minus_cursors(resource);
+    minus_cursors.reserve(minus_terms.size());
+    for (const TermData* term : minus_terms) {
+        minus_cursors.push_back(MakeCursor<Cursor>(*term));
+    }
+    // Documents come in increasing id order, so minus cursors only move forward, galloping
+    [[maybe_unused]] size_t minus_filtered_count = 0;
+    const auto has_minus_word = [&minus_cursors, &minus_filtered_count](int internal_id) {
+        const bool has_minus_word = std::any_of(minus_cursors.begin(), minus_cursors.end(),
+            [internal_id](Cursor& cursor) {
+                cursor.Advance(internal_id);
+                return !cursor.AtEnd() && cursor.GetDocumentId() == internal_id;
+            }
+        );
+        minus_filtered_count += has_minus_word;
+        return has_minus_word;
+    };
+
+    std::pmr::vector<Document> candidates(resource);
+    std::priority_queue<double, std::pmr::vector<double>, std::greater<double>> top_relevances{
+        std::greater<double>(), std::pmr::vector<double>(resource) };
+    // A document that cannot reach the threshold is beaten by top_count documents
+    // in IsMoreRelevant, which ignores differences below eps; another eps covers rounding
+    double threshold = -std::numeric_limits<double>::infinity();
+    // Terms [0, essential_begin) cannot bring a document to the threshold on their own
+    size_t essential_begin = 0;
+    std::pmr::vector<std::pair<size_t, double>> word_scores(resource);
+    size_t scored_posting_count = 0;
+
+    while (true) {
+        bool found = false;
+        int internal_id = 0;
+        for (size_t i = essential_begin; i < terms.size(); ++i) {
+            const auto& cursor = terms[i].cursor;
+            if (!cursor.AtEnd() && (!found || cursor.GetDocumentId() < internal_id)) {
+                internal_id = cursor.GetDocumentId();
+                found = true;
+            }
         }
-    );
-    std::for_each(policy, ptrs_on_words.begin(), ptrs_on_words.end(),
-        [&](const auto& ptr_on_word) {
-            word_to_document_freqs_.at(std::string(ptr_on_word)).erase(document_id);
+        if (!found) {
+            break;
         }
-    );
-    document_ids_.erase(document_id);
-    documents_.erase(document_id);
-    document_to_word_freqs_.erase(document_id);
+
+        double max_relevance = essential_begin > 0 ? max_score_sums[essential_begin - 1] : 0.0;
+        for (size_t i = essential_begin; i < terms.size(); ++i) {
+            const auto& cursor = terms[i].cursor;
+            if (!cursor.AtEnd() && cursor.GetDocumentId() == internal_id) {
+                max_relevance += terms[i].max_score;
+            }
+        }
+        if (max_relevance >= threshold && !has_minus_word(internal_id)
+            && AcceptsDocument(document_predicate, internal_id)) {
+            word_scores.clear();
+            for (size_t i = essential_begin; i < terms.size(); ++i) {
+                const auto& term = terms[i];
+                if (!term.cursor.AtEnd() && term.cursor.GetDocumentId() == internal_id) {
+                    const double score = GetTermFreq(term.cursor) * term.inverse_document_freq;
+                    word_scores.push_back({ term.word_index, score });
+                    max_relevance += score - term.max_score;
+                }
+            }
+            for (size_t i = essential_begin; i-- > 0 && max_relevance >= threshold;) {
+                auto& term = terms[i];
+                term.cursor.Advance(internal_id);
+                max_relevance -= term.max_score;
+                if (!term.cursor.AtEnd() && term.cursor.GetDocumentId() == internal_id) {
+                    const double score = GetTermFreq(term.cursor) * term.inverse_document_freq;
+                    word_scores.push_back({ term.word_index, score });
+                    max_relevance += score;
+                }
+            }
+            scored_posting_count += word_scores.size();
+
+            if (max_relevance >= threshold) {
+                std::sort(word_scores.begin(), word_scores.end());
+                double relevance = 0.0;
+                for (const auto& [_, score] : word_scores) {
+                    relevance += score;
+                }
+                candidates.push_back({ documents_.GetDocumentId(internal_id), relevance, documents_.GetRating(internal_id) });
+            }
+            if (top_count && max_relevance >= threshold) {
+                top_relevances.push(candidates.back().relevance);
+                if (top_relevances.size() > *top_count) {
+                    top_relevances.pop();
+                }
+                if (top_relevances.size() == *top_count) {
+                    threshold = top_relevances.top() - 2 * eps;
+                    while (essential_begin < terms.size() && max_score_sums[essential_begin] < threshold) {
+                        ++essential_begin;
+                    }
+                }
+            }
+        }
+
+        for (auto& term : terms) {
+            if (!term.cursor.AtEnd() && term.cursor.GetDocumentId() == internal_id) {
+                term.cursor.Next();
+            }
+        }
+    }
+    *scored_posting_count_ += scored_posting_count;
+    METRICS_COUNT(SCORED_POSTINGS, scored_posting_count);
+    METRICS_COUNT(MINUS_FILTERED_DOCUMENTS, minus_filtered_count);
+    return candidates;
 }
 
-template<typename ExecutionPolicy>
-std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(
-    ExecutionPolicy&& policy, const std::string_view raw_query, int document_id) const {
+template <typename Cursor>
+Cursor SearchServer::MakeCursor(const TermData& term) {
+    if constexpr (std::is_same_v<Cursor, PostingList::Cursor>) {
+        return Cursor(term.postings);
+    }
+    else {
+        return Cursor(term.compressed_postings);
+    }
+}
+
+template <typename DocumentPredicate>
+bool SearchServer::AcceptsDocument(const DocumentPredicate& document_predicate, uint32_t internal_id) const {
+    return document_predicate(documents_.GetDocumentId(internal_id), documents_.GetStatus(internal_id),
+        documents_.GetRating(internal_id));
+}
 
-    if (document_to_word_freqs_.count(document_id) == 0) {
-        throw std::out_of_range(" id  ");
+template <typename Function>
+void SearchServer::ForEachPosting(const TermData& term, size_t first, size_t last, Function function) const {
+    if (posting_format_ == PostingFormat::PLAIN) {
+        for (const auto [internal_id, term_freq] : term.postings.GetSlice(first, last)) {
+            function(internal_id, term_freq);
+        }
+    }
+    else {
+        term.compressed_postings.ForEach(first, last,
+            [this, &function](int internal_id, uint32_t count) {
+                function(internal_id, ComputeTermFreq(count, documents_.GetWordCount(internal_id)));
+            }
+        );
     }
+}
 
-    const auto query = ParseQuery(raw_query);
-    if (std::any_of(policy, query.minus_words.begin(), query.minus_words.end(),
-        [this, document_id](const auto& minus_word) {
-            return word_to_document_freqs_.at(std::string(minus_word)).count(document_id);
+template <typename Function>
+void SearchServer::ForEachInternalId(const TermData& term, size_t first, size_t last, Function function) const {
+    if (posting_format_ == PostingFormat::PLAIN) {
+        for (const auto& posting : term.postings.GetSlice(first, last)) {
+            function(posting.document_id);
         }
-    )) {
-        return { {}, documents_.at(document_id).status };
     }
-    std::vector<std::string_view> matched_words(query.plus_words.size());
-    std::copy_if(policy,
-                 query.plus_words.begin(), query.plus_words.end(), 
-                  matched_words.begin(),
-                 [this, document_id](const auto& plus_word) {
-                     return word_to_document_freqs_.at(std::string(plus_word)).count(document_id);
-                 }
-    );
+    else {
+        term.compressed_postings.ForEach(first, last,
+            [&function](int internal_id, uint32_t) {
+                function(internal_id);
+            }
+        );
+    }
+}
+
+template<typename ExecutionPolicy>
+void SearchServer::RemoveDocument(ExecutionPolicy&& policy, int document_id) {
+    const uint32_t internal_id = documents_.Find(document_id);
+    if (internal_id == DocumentTable::NO_DOCUMENT) {
+        return;
+    }
+    const auto items = forward_index_.Get(internal_id);
+    std::vector<TermId> term_ids(items.size());
 
-    std::sort(policy, matched_words.begin(), matched_words.end());
-    auto words_new_end = std::unique(policy, matched_words.begin(), matched_words.end());
-    matched_words.erase(words_new_end, matched_words.end());
-    if (matched_words.at(0) == "") {
-        matched_words.erase(matched_words.begin());
+    std::transform(policy, items.begin(), items.end(), term_ids.begin(),
+        [](const TermFrequency& item) {
+            return item.term_id;
+        }
+    );
+    if constexpr (std::is_same_v<std::decay_t<ExecutionPolicy>, std::execution::parallel_policy>) {
+        thread_pool_->ParallelFor(term_ids.size(),
+            [this, &term_ids, internal_id](size_t i) {
+                RemovePosting(term_data_[term_ids[i]], internal_id);
+                UpdateLogDocumentFreq(term_ids[i]);
+            }
+        );
     }
-    return { matched_words, documents_.at(document_id).status };
+    else {
+        std::for_each(policy, term_ids.begin(), term_ids.end(),
+            [&](TermId term_id) {
+                RemovePosting(term_data_[term_id], internal_id);
+                UpdateLogDocumentFreq(term_id);
+            }
+        );
+    }
+    documents_.Remove(internal_id);
+    forward_index_.Remove(internal_id);
+    CompactInternalIds();
+    UpdateLogDocumentCount();
+    ++generation_;
+}
+
+template<typename ExecutionPolicy>
+std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(
+    ExecutionPolicy&&, const std::string_view raw_query, int document_id) const {
+    return MatchDocument(raw_query, document_id);
 }
\ No newline at end of file
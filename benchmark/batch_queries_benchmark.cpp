@@ -0,0 +1,82 @@
+#include "search_server.h"
+#include "process_queries.h"
+#include "log_duration.h"
+#include "generators.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// What ProcessQueriesJoined did before batching: a search per query, joined into a list
+list<Document> FindOneByOne(const SearchServer& search_server, const vector<string>& queries) {
+    vector<vector<Document>> search_results(queries.size());
+    search_server.GetThreadPool().ParallelFor(queries.size(),
+        [&search_server, &queries, &search_results](size_t i) {
+            search_results[i] = search_server.FindTopDocuments(queries[i]);
+        }
+    );
+    list<Document> documents;
+    for (auto& query_documents : search_results) {
+        for (auto& document : query_documents) {
+            documents.push_back(move(document));
+        }
+    }
+    return documents;
+}
+
+// Documents with equal relevance may come in another order
+bool HaveSameRelevances(const list<Document>& lhs, const vector<Document>& rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    auto it = lhs.begin();
+    for (const Document& document : rhs) {
+        if (abs(it++->relevance - document.relevance) > eps) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Run(const string& mark, const SearchServer& search_server, const vector<string>& queries) {
+    list<Document> one_by_one;
+    {
+        LOG_DURATION(mark + " one by one"s);
+        one_by_one = FindOneByOne(search_server, queries);
+    }
+    vector<Document> batch;
+    {
+        LOG_DURATION(mark + " batch"s);
+        batch = ProcessQueriesJoined(search_server, queries);
+    }
+    cout << mark << (HaveSameRelevances(one_by_one, batch) ? " results match"s : " RESULTS DIFFER"s) << endl;
+}
+
+// Usage: batch_queries_benchmark [document_count] [query_count]
+int main(int argc, char* argv[]) {
+    const int document_count = argc > 1 ? atoi(argv[1]) : 20'000;
+    const int query_count = argc > 2 ? atoi(argv[2]) : 100'000;
+
+    mt19937 generator;
+    const auto dictionary = GenerateDictionary(generator, 2000, 10);
+    const auto documents = GenerateQueries(generator, dictionary, document_count, 70);
+    vector<string> queries;
+    queries.reserve(query_count);
+    for (int i = 0; i < query_count; ++i) {
+        queries.push_back(GenerateQuery(generator, dictionary, 6, 0.1));
+    }
+
+    for (const auto posting_format : { PostingFormat::PLAIN, PostingFormat::COMPRESSED }) {
+        SearchServer search_server(dictionary[0], ThreadPool::GetDefault(), posting_format);
+        for (int i = 0; i < document_count; ++i) {
+            search_server.AddDocument(i, documents[i], DocumentStatus::ACTUAL, { i % 7 });
+        }
+        Run(posting_format == PostingFormat::PLAIN ? "PLAIN"s : "COMPRESSED"s, search_server, queries);
+    }
+}
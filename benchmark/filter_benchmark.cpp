@@ -0,0 +1,74 @@
+#include "search_server.h"
+#include "log_duration.h"
+#include "generators.h"
+
+#include <cstdlib>
+#include <execution>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+template <typename Search>
+void Test(string_view mark, const vector<string>& queries, Search search) {
+    LOG_DURATION(mark);
+    double total_relevance = 0;
+    for (const string_view query : queries) {
+        for (const auto& document : search(query)) {
+            total_relevance += document.relevance;
+        }
+    }
+    cout << total_relevance << endl;
+}
+
+// Status and rating filters compared with the same conditions as predicates.
+// Usage: filter_benchmark [document_count] [query_word_count]
+int main(int argc, char* argv[]) {
+    const int document_count = argc > 1 ? atoi(argv[1]) : 20'000;
+    const int query_word_count = argc > 2 ? atoi(argv[2]) : 10;
+
+    mt19937 generator;
+    const auto dictionary = GenerateDictionary(generator, 1000, 10);
+    const auto documents = GenerateQueries(generator, dictionary, document_count, 70);
+    const auto queries = GenerateQueries(generator, dictionary, 100, query_word_count);
+
+    SearchServer search_server(dictionary[0]);
+    for (int i = 0; i < document_count; ++i) {
+        // One document in ten is banned, ratings run from -50 to 50
+        const auto status = i % 10 == 0 ? DocumentStatus::BANNED : DocumentStatus::ACTUAL;
+        search_server.AddDocument(i, documents[i], status, { i % 101 - 50 });
+    }
+
+    const auto is_banned = [](int, DocumentStatus status, int) {
+        return status == DocumentStatus::BANNED;
+    };
+    const auto is_good = [](int, DocumentStatus status, int rating) {
+        return status == DocumentStatus::ACTUAL && rating >= 40;
+    };
+    Test("seq banned predicate"sv, queries, [&](string_view query) {
+        return search_server.FindTopDocuments(execution::seq, query, is_banned);
+    });
+    Test("seq banned filter"sv, queries, [&](string_view query) {
+        return search_server.FindTopDocuments(execution::seq, query, DocumentStatus::BANNED);
+    });
+    Test("par banned predicate"sv, queries, [&](string_view query) {
+        return search_server.FindTopDocuments(execution::par, query, is_banned);
+    });
+    Test("par banned filter"sv, queries, [&](string_view query) {
+        return search_server.FindTopDocuments(execution::par, query, DocumentStatus::BANNED);
+    });
+    Test("seq rating predicate"sv, queries, [&](string_view query) {
+        return search_server.FindTopDocuments(execution::seq, query, is_good);
+    });
+    Test("seq rating filter"sv, queries, [&](string_view query) {
+        return search_server.FindTopDocuments(execution::seq, query, DocumentStatus::ACTUAL, RatingRange{ 40, 50 });
+    });
+    Test("par rating predicate"sv, queries, [&](string_view query) {
+        return search_server.FindTopDocuments(execution::par, query, is_good);
+    });
+    Test("par rating filter"sv, queries, [&](string_view query) {
+        return search_server.FindTopDocuments(execution::par, query, DocumentStatus::ACTUAL, RatingRange{ 40, 50 });
+    });
+}
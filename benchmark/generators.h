@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+inline std::string GenerateWord(std::mt19937& generator, int max_length) {
+    const int length = std::uniform_int_distribution(1, max_length)(generator);
+    std::string word;
+    word.reserve(length);
+    for (int i = 0; i < length; ++i) {
+        word.push_back(std::uniform_int_distribution(int('a'), int('z'))(generator));
+    }
+    return word;
+}
+
+inline std::vector<std::string> GenerateDictionary(std::mt19937& generator, int word_count, int max_length) {
+    std::vector<std::string> words;
+    words.reserve(word_count);
+    for (int i = 0; i < word_count; ++i) {
+        words.push_back(GenerateWord(generator, max_length));
+    }
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    return words;
+}
+
+inline std::string GenerateQuery(std::mt19937& generator, const std::vector<std::string>& dictionary,
+    int word_count, double minus_prob = 0) {
+    std::string query;
+    for (int i = 0; i < word_count; ++i) {
+        if (!query.empty()) {
+            query.push_back(' ');
+        }
+        if (std::uniform_real_distribution<>(0, 1)(generator) < minus_prob) {
+            query.push_back('-');
+        }
+        query += dictionary[std::uniform_int_distribution<int>(0, dictionary.size() - 1)(generator)];
+    }
+    return query;
+}
+
+inline std::vector<std::string> GenerateQueries(std::mt19937& generator, const std::vector<std::string>& dictionary,
+    int query_count, int max_word_count) {
+    std::vector<std::string> queries;
+    queries.reserve(query_count);
+    for (int i = 0; i < query_count; ++i) {
+        queries.push_back(GenerateQuery(generator, dictionary, max_word_count));
+    }
+    return queries;
+}
+
+// Draws indices in [0, size) with probabilities proportional to 1 / (index + 1)^exponent.
+// Only the raw output of the generator is used, so a seed gives the same draws with any standard library
+class ZipfDistribution {
+public:
+    explicit ZipfDistribution(size_t size, double exponent = 1.0) {
+        cumulative_weights_.reserve(size);
+        double weight_sum = 0.0;
+        for (size_t i = 0; i < size; ++i) {
+            weight_sum += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+            cumulative_weights_.push_back(weight_sum);
+        }
+    }
+
+    size_t operator()(std::mt19937& generator) const {
+        // Uniform in (0, 1) from 32 random bits
+        const double uniform = (generator() + 0.5) / 4294967296.0;
+        const auto it = std::lower_bound(cumulative_weights_.begin(), cumulative_weights_.end(),
+            uniform * cumulative_weights_.back());
+        return std::min<size_t>(it - cumulative_weights_.begin(), cumulative_weights_.size() - 1);
+    }
+
+private:
+    std::vector<double> cumulative_weights_;
+};
+
+// Distinct words of letters 'a' to 'z', the word of index i is i in base 26.
+// Frequent words come first, so they are also the shortest
+inline std::vector<std::string> GenerateIndexedDictionary(size_t word_count) {
+    std::vector<std::string> words;
+    words.reserve(word_count);
+    for (size_t i = 0; i < word_count; ++i) {
+        std::string word;
+        for (size_t rest = i + 1; rest > 0; rest = (rest - 1) / 26) {
+            word.push_back(static_cast<char>('a' + (rest - 1) % 26));
+        }
+        words.push_back(std::move(word));
+    }
+    return words;
+}
+
+// Texts of min_word_count to max_word_count words of dictionary drawn by zipf.
+// A word gets a '-' prefix with probability minus_share
+inline std::vector<std::string> GenerateZipfTexts(std::mt19937& generator, const std::vector<std::string>& dictionary,
+    const ZipfDistribution& zipf, size_t text_count, size_t min_word_count, size_t max_word_count,
+    double minus_share = 0.0) {
+    std::vector<std::string> texts;
+    texts.reserve(text_count);
+    for (size_t i = 0; i < text_count; ++i) {
+        const size_t word_count = min_word_count + generator() % (max_word_count - min_word_count + 1);
+        std::string text;
+        for (size_t j = 0; j < word_count; ++j) {
+            if (j > 0) {
+                text.push_back(' ');
+            }
+            if ((generator() + 0.5) / 4294967296.0 < minus_share) {
+                text.push_back('-');
+            }
+            text += dictionary[zipf(generator)];
+        }
+        texts.push_back(std::move(text));
+    }
+    return texts;
+}
@@ -0,0 +1,41 @@
+#include "search_server.h"
+#include "log_duration.h"
+#include "generators.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Usage: ingestion_benchmark [document_count] [words_per_document]
+int main(int argc, char* argv[]) {
+    const int document_count = argc > 1 ? atoi(argv[1]) : 1'000'000;
+    const int word_count = argc > 2 ? atoi(argv[2]) : 10;
+
+    mt19937 generator;
+    const auto dictionary = GenerateDictionary(generator, 10'000, 10);
+    const auto documents = GenerateQueries(generator, dictionary, document_count, word_count);
+    cout << document_count << " documents of "s << word_count << " words"s << endl;
+
+    {
+        SearchServer search_server(dictionary[0]);
+        LOG_DURATION("AddDocument loop"s);
+        for (int i = 0; i < document_count; ++i) {
+            search_server.AddDocument(i, documents[i], DocumentStatus::ACTUAL, { 1, 2, 3 });
+        }
+    }
+
+    {
+        SearchServer search_server(dictionary[0]);
+        vector<DocumentInput> batch;
+        batch.reserve(documents.size());
+        for (int i = 0; i < document_count; ++i) {
+            batch.push_back({ i, documents[i], DocumentStatus::ACTUAL, { 1, 2, 3 } });
+        }
+        LOG_DURATION("AddDocuments batch"s);
+        search_server.AddDocuments(batch);
+    }
+}
@@ -0,0 +1,61 @@
+#include "search_server.h"
+#include "process_queries.h"
+#include "search_metrics.h"
+#include "generators.h"
+
+#include <cstdlib>
+#include <execution>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Runs sequential, parallel and batched queries and prints the metrics of each run.
+// Usage: metrics_report [document_count] [query_count] [text|json]
+int main(int argc, char* argv[]) {
+    const int document_count = argc > 1 ? atoi(argv[1]) : 10'000;
+    const int query_count = argc > 2 ? atoi(argv[2]) : 2'000;
+    const bool json = argc > 3 && argv[3] == "json"sv;
+
+    mt19937 generator;
+    const auto dictionary = GenerateDictionary(generator, 1000, 10);
+    const auto documents = GenerateQueries(generator, dictionary, document_count, 70);
+    vector<string> queries;
+    for (int i = 0; i < query_count; ++i) {
+        queries.push_back(GenerateQuery(generator, dictionary, 8, 0.1));
+    }
+
+    SearchServer search_server(dictionary[0]);
+    for (int i = 0; i < document_count; ++i) {
+        search_server.AddDocument(i, documents[i], DocumentStatus::ACTUAL, { i % 7 });
+    }
+
+    const auto report = [json](string_view mark) {
+        const auto snapshot = GetMetricsSnapshot();
+        if (json) {
+            cout << "{\"run\":\""sv << mark << "\",\"metrics\":"sv;
+            snapshot.PrintJson(cout);
+            cout << '}' << endl;
+        }
+        else {
+            cout << "== "sv << mark << " ==\n"sv;
+            snapshot.PrintText(cout);
+        }
+        ResetMetrics();
+    };
+
+    report("add"sv);
+    for (const string& query : queries) {
+        search_server.FindTopDocuments(execution::seq, query);
+    }
+    report("seq"sv);
+    for (const string& query : queries) {
+        search_server.FindTopDocuments(execution::par, query);
+    }
+    report("par"sv);
+    ProcessQueries(search_server, queries);
+    report("batch"sv);
+}
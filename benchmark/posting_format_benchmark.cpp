@@ -0,0 +1,47 @@
+#include "search_server.h"
+#include "log_duration.h"
+#include "generators.h"
+
+#include <cstdlib>
+#include <execution>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+template <typename ExecutionPolicy>
+void Test(const string& mark, const SearchServer& search_server, const vector<string>& queries, ExecutionPolicy&& policy) {
+    LOG_DURATION(mark);
+    double total_relevance = 0;
+    for (const string_view query : queries) {
+        for (const auto& document : search_server.FindTopDocuments(policy, query)) {
+            total_relevance += document.relevance;
+        }
+    }
+    cout << total_relevance << endl;
+}
+
+void Run(const string& name, PostingFormat posting_format, const vector<string>& documents, const vector<string>& queries) {
+    SearchServer search_server(""s, ThreadPool::GetDefault(), posting_format);
+    for (size_t i = 0; i < documents.size(); ++i) {
+        search_server.AddDocument(i, documents[i], DocumentStatus::ACTUAL, { 1, 2, 3 });
+    }
+    cout << name << " postings: "s << search_server.GetPostingsMemoryUsage() / (1 << 20) << " MB"s << endl;
+    Test(name + " seq"s, search_server, queries, execution::seq);
+    Test(name + " par"s, search_server, queries, execution::par);
+}
+
+// Usage: posting_format_benchmark [document_count]
+int main(int argc, char* argv[]) {
+    const int document_count = argc > 1 ? atoi(argv[1]) : 20'000;
+
+    mt19937 generator;
+    const auto dictionary = GenerateDictionary(generator, 1000, 10);
+    const auto documents = GenerateQueries(generator, dictionary, document_count, 70);
+    const auto queries = GenerateQueries(generator, dictionary, 100, 70);
+
+    Run("PLAIN"s, PostingFormat::PLAIN, documents, queries);
+    Run("COMPRESSED"s, PostingFormat::COMPRESSED, documents, queries);
+}
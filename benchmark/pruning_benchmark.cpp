@@ -0,0 +1,67 @@
+#include "search_server.h"
+#include "log_duration.h"
+#include "generators.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+vector<vector<Document>> Run(const string& mark, SearchServer& search_server, const vector<string>& queries, bool dynamic_pruning) {
+    search_server.SetDynamicPruning(dynamic_pruning);
+    const size_t scored_before = search_server.GetScoredPostingCount();
+    vector<vector<Document>> results;
+    results.reserve(queries.size());
+    {
+        LOG_DURATION(mark);
+        for (const string& query : queries) {
+            results.push_back(search_server.FindTopDocuments(query));
+        }
+    }
+    cout << mark << " postings scored per query: "s
+        << (search_server.GetScoredPostingCount() - scored_before) / queries.size() << endl;
+    return results;
+}
+
+bool AreSame(const vector<vector<Document>>& lhs, const vector<vector<Document>>& rhs) {
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        if (lhs[i].size() != rhs[i].size()) {
+            return false;
+        }
+        for (size_t j = 0; j < lhs[i].size(); ++j) {
+            if (lhs[i][j].id != rhs[i][j].id || lhs[i][j].relevance != rhs[i][j].relevance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Usage: pruning_benchmark [document_count] [query_word_count] [minus_word_prob]
+int main(int argc, char* argv[]) {
+    const int document_count = argc > 1 ? atoi(argv[1]) : 10'000;
+    const int query_word_count = argc > 2 ? atoi(argv[2]) : 70;
+    const double minus_word_prob = argc > 3 ? atof(argv[3]) : 0.0;
+
+    mt19937 generator;
+    const auto dictionary = GenerateDictionary(generator, 1000, 10);
+    const auto documents = GenerateQueries(generator, dictionary, document_count, 70);
+    vector<string> queries;
+    for (int i = 0; i < 100; ++i) {
+        queries.push_back(GenerateQuery(generator, dictionary, query_word_count, minus_word_prob));
+    }
+
+    for (const auto posting_format : { PostingFormat::PLAIN, PostingFormat::COMPRESSED }) {
+        SearchServer search_server(dictionary[0], ThreadPool::GetDefault(), posting_format);
+        for (int i = 0; i < document_count; ++i) {
+            search_server.AddDocument(i, documents[i], DocumentStatus::ACTUAL, { i % 7 });
+        }
+        const string name = posting_format == PostingFormat::PLAIN ? "PLAIN"s : "COMPRESSED"s;
+        const auto exhaustive = Run(name + " exhaustive"s, search_server, queries, false);
+        const auto pruned = Run(name + " pruned"s, search_server, queries, true);
+        cout << name << (AreSame(exhaustive, pruned) ? " results match"s : " RESULTS DIFFER"s) << endl;
+    }
+}
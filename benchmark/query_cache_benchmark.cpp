@@ -0,0 +1,69 @@
+#include "search_server.h"
+#include "process_queries.h"
+#include "request_queue.h"
+#include "log_duration.h"
+#include "generators.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+void PrintStats(const string& mark, const SearchServer& search_server) {
+    const auto stats = search_server.GetResultCacheStats();
+    cout << mark << " hits: "s << stats.hits << ", misses: "s << stats.misses
+        << ", evictions: "s << stats.evictions << endl;
+}
+
+void Run(const string& mark, SearchServer& search_server, const vector<string>& queries, size_t cache_capacity) {
+    search_server.SetResultCacheCapacity(cache_capacity);
+    size_t document_count = 0;
+    {
+        LOG_DURATION(mark + " ProcessQueries"s);
+        for (const auto& documents : ProcessQueries(search_server, queries)) {
+            document_count += documents.size();
+        }
+    }
+    {
+        LOG_DURATION(mark + " RequestQueue"s);
+        RequestQueue request_queue(search_server);
+        for (const string& query : queries) {
+            document_count += request_queue.AddFindRequest(query).size();
+        }
+    }
+    cout << mark << " documents found: "s << document_count << endl;
+    PrintStats(mark, search_server);
+}
+
+// Queries drawn from a pool with a skewed distribution, with and without the result cache.
+// Usage: query_cache_benchmark [document_count] [distinct_query_count] [cache_capacity]
+int main(int argc, char* argv[]) {
+    const int document_count = argc > 1 ? atoi(argv[1]) : 10'000;
+    const int distinct_query_count = argc > 2 ? atoi(argv[2]) : 5'000;
+    const size_t cache_capacity = argc > 3 ? atoi(argv[3]) : 1'000;
+
+    mt19937 generator;
+    const auto dictionary = GenerateDictionary(generator, 1000, 10);
+    const auto documents = GenerateQueries(generator, dictionary, document_count, 70);
+    const auto query_pool = GenerateQueries(generator, dictionary, distinct_query_count, 10);
+    // Query i is drawn with a weight of 1 / (i + 1)
+    vector<double> weights;
+    for (int i = 0; i < distinct_query_count; ++i) {
+        weights.push_back(1.0 / (i + 1));
+    }
+    discrete_distribution<int> query_distribution(weights.begin(), weights.end());
+    vector<string> queries;
+    for (int i = 0; i < 20'000; ++i) {
+        queries.push_back(query_pool[query_distribution(generator)]);
+    }
+
+    SearchServer search_server(dictionary[0]);
+    for (int i = 0; i < document_count; ++i) {
+        search_server.AddDocument(i, documents[i], DocumentStatus::ACTUAL, { i % 7 });
+    }
+    Run("no cache"s, search_server, queries, 0);
+    Run("cache"s, search_server, queries, cache_capacity);
+}
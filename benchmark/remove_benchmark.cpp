@@ -0,0 +1,85 @@
+#include "search_server.h"
+#include "log_duration.h"
+#include "generators.h"
+
+#include <cstdlib>
+#include <execution>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+SearchServer MakeServer(const vector<string>& dictionary, const vector<string>& documents, PostingFormat posting_format) {
+    SearchServer search_server(dictionary[0], ThreadPool::GetDefault(), posting_format);
+    vector<DocumentInput> inputs;
+    for (size_t i = 0; i < documents.size(); ++i) {
+        inputs.push_back({ static_cast<int>(i), documents[i], DocumentStatus::ACTUAL, { 1 } });
+    }
+    search_server.AddDocuments(inputs);
+    return search_server;
+}
+
+vector<vector<Document>> FindAll(const SearchServer& search_server, const vector<string>& queries) {
+    vector<vector<Document>> results;
+    for (const string& query : queries) {
+        results.push_back(search_server.FindTopDocuments(query));
+    }
+    return results;
+}
+
+bool AreSame(const vector<vector<Document>>& lhs, const vector<vector<Document>>& rhs) {
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        if (lhs[i].size() != rhs[i].size()) {
+            return false;
+        }
+        for (size_t j = 0; j < lhs[i].size(); ++j) {
+            if (lhs[i][j].id != rhs[i][j].id || lhs[i][j].relevance != rhs[i][j].relevance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Removes every second document one by one, seq and par, and in one batch.
+// Usage: remove_benchmark [document_count]
+int main(int argc, char* argv[]) {
+    const int document_count = argc > 1 ? atoi(argv[1]) : 100'000;
+
+    mt19937 generator;
+    const auto dictionary = GenerateDictionary(generator, 1000, 10);
+    const auto documents = GenerateQueries(generator, dictionary, document_count, 30);
+    const auto queries = GenerateQueries(generator, dictionary, 100, 5);
+    vector<int> removed_ids;
+    for (int i = 0; i < document_count; i += 2) {
+        removed_ids.push_back(i);
+    }
+
+    for (const auto posting_format : { PostingFormat::PLAIN, PostingFormat::COMPRESSED }) {
+        const string name = posting_format == PostingFormat::PLAIN ? "PLAIN"s : "COMPRESSED"s;
+        auto seq_server = MakeServer(dictionary, documents, posting_format);
+        auto par_server = MakeServer(dictionary, documents, posting_format);
+        auto batch_server = MakeServer(dictionary, documents, posting_format);
+        {
+            LOG_DURATION(name + " RemoveDocument seq"s);
+            for (const int document_id : removed_ids) {
+                seq_server.RemoveDocument(execution::seq, document_id);
+            }
+        }
+        {
+            LOG_DURATION(name + " RemoveDocument par"s);
+            for (const int document_id : removed_ids) {
+                par_server.RemoveDocument(execution::par, document_id);
+            }
+        }
+        {
+            LOG_DURATION(name + " RemoveDocuments"s);
+            batch_server.RemoveDocuments(removed_ids);
+        }
+        const auto expected = FindAll(seq_server, queries);
+        const bool same = AreSame(expected, FindAll(par_server, queries)) && AreSame(expected, FindAll(batch_server, queries));
+        cout << name << (same ? " results match"s : " RESULTS DIFFER"s) << endl;
+    }
+}
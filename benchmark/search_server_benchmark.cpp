@@ -0,0 +1,226 @@
+#include "search_server.h"
+#include "paginator.h"
+#include "process_queries.h"
+#include "generators.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <execution>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Google Benchmark suite over corpora of 1k documents and every ten times larger
+// size up to --max_documents (100k by default). Words of documents and queries
+// follow Zipf's law over a fixed dictionary, and every corpus is generated from
+// a fixed seed, so runs on any machine search the same documents.
+// JSON results: --benchmark_out=results.json --benchmark_out_format=json
+
+namespace {
+
+constexpr unsigned SEED = 20'240'601;
+constexpr size_t DICTIONARY_SIZE = 50'000;
+constexpr size_t QUERY_COUNT = 1'000;
+constexpr size_t PAGE_SIZE = 2;
+
+struct Corpus {
+    vector<string> texts;
+    vector<string> queries;
+    // The most frequent words
+    string stop_words;
+};
+
+const Corpus& GetCorpus(size_t document_count) {
+    static map<size_t, unique_ptr<Corpus>> corpora;
+    auto& corpus = corpora[document_count];
+    if (!corpus) {
+        mt19937 generator(SEED + static_cast<unsigned>(document_count));
+        const auto dictionary = GenerateIndexedDictionary(DICTIONARY_SIZE);
+        const ZipfDistribution zipf(dictionary.size());
+        corpus = make_unique<Corpus>();
+        corpus->texts = GenerateZipfTexts(generator, dictionary, zipf, document_count, 10, 100);
+        corpus->queries = GenerateZipfTexts(generator, dictionary, zipf, QUERY_COUNT, 1, 8, 0.1);
+        corpus->stop_words = dictionary[0] + ' ' + dictionary[1] + ' ' + dictionary[2];
+    }
+    return *corpus;
+}
+
+void AddCorpus(SearchServer& search_server, const Corpus& corpus) {
+    for (size_t i = 0; i < corpus.texts.size(); ++i) {
+        search_server.AddDocument(static_cast<int>(i), corpus.texts[i],
+            i % 10 == 0 ? DocumentStatus::IRRELEVANT : DocumentStatus::ACTUAL, { static_cast<int>(i % 11) - 5 });
+    }
+}
+
+// Servers are shared by the benchmarks that do not change them
+const SearchServer& GetServer(size_t document_count) {
+    static map<size_t, unique_ptr<SearchServer>> servers;
+    auto& search_server = servers[document_count];
+    if (!search_server) {
+        const auto& corpus = GetCorpus(document_count);
+        search_server = make_unique<SearchServer>(corpus.stop_words);
+        AddCorpus(*search_server, corpus);
+    }
+    return *search_server;
+}
+
+void AddDocumentBenchmark(benchmark::State& state) {
+    const auto& corpus = GetCorpus(state.range(0));
+    for (auto _ : state) {
+        SearchServer search_server(corpus.stop_words);
+        AddCorpus(search_server, corpus);
+        benchmark::DoNotOptimize(search_server.GetDocumentCount());
+    }
+    state.SetItemsProcessed(state.iterations() * corpus.texts.size());
+}
+
+void AddDocumentsBenchmark(benchmark::State& state) {
+    const auto& corpus = GetCorpus(state.range(0));
+    vector<DocumentInput> documents;
+    documents.reserve(corpus.texts.size());
+    for (size_t i = 0; i < corpus.texts.size(); ++i) {
+        documents.push_back({ static_cast<int>(i), corpus.texts[i], DocumentStatus::ACTUAL, { static_cast<int>(i % 11) - 5 } });
+    }
+    for (auto _ : state) {
+        SearchServer search_server(corpus.stop_words);
+        benchmark::DoNotOptimize(search_server.AddDocuments(documents));
+    }
+    state.SetItemsProcessed(state.iterations() * corpus.texts.size());
+}
+
+template <typename ExecutionPolicy>
+void FindTopDocumentsBenchmark(benchmark::State& state, ExecutionPolicy policy) {
+    const auto& corpus = GetCorpus(state.range(0));
+    const auto& search_server = GetServer(state.range(0));
+    size_t query_index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(search_server.FindTopDocuments(policy, corpus.queries[query_index]));
+        query_index = (query_index + 1) % corpus.queries.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void MatchDocumentBenchmark(benchmark::State& state) {
+    const auto& corpus = GetCorpus(state.range(0));
+    const auto& search_server = GetServer(state.range(0));
+    size_t query_index = 0;
+    for (auto _ : state) {
+        const int document_id = static_cast<int>(query_index * 7919 % corpus.texts.size());
+        benchmark::DoNotOptimize(search_server.MatchDocument(corpus.queries[query_index], document_id));
+        query_index = (query_index + 1) % corpus.queries.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// One query against every document of the corpus
+void MatchDocumentsBenchmark(benchmark::State& state) {
+    const auto& corpus = GetCorpus(state.range(0));
+    const auto& search_server = GetServer(state.range(0));
+    vector<int> document_ids(corpus.texts.size());
+    for (size_t i = 0; i < document_ids.size(); ++i) {
+        document_ids[i] = static_cast<int>(i);
+    }
+    size_t query_index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(search_server.MatchDocuments(corpus.queries[query_index], document_ids));
+        query_index = (query_index + 1) % corpus.queries.size();
+    }
+    state.SetItemsProcessed(state.iterations() * document_ids.size());
+}
+
+// Every removed document is added back outside of the measured time
+void RemoveDocumentBenchmark(benchmark::State& state) {
+    const auto& corpus = GetCorpus(state.range(0));
+    SearchServer search_server(corpus.stop_words);
+    AddCorpus(search_server, corpus);
+    size_t document_index = 0;
+    for (auto _ : state) {
+        search_server.RemoveDocument(static_cast<int>(document_index));
+        state.PauseTiming();
+        search_server.AddDocument(static_cast<int>(document_index), corpus.texts[document_index],
+            DocumentStatus::ACTUAL, { 0 });
+        document_index = (document_index + 1) % corpus.texts.size();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void ProcessQueriesBenchmark(benchmark::State& state) {
+    const auto& corpus = GetCorpus(state.range(0));
+    const auto& search_server = GetServer(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ProcessQueriesJoined(search_server, corpus.queries));
+    }
+    state.SetItemsProcessed(state.iterations() * corpus.queries.size());
+}
+
+void PaginatorBenchmark(benchmark::State& state) {
+    const auto& corpus = GetCorpus(state.range(0));
+    const auto documents = ProcessQueriesJoined(GetServer(state.range(0)), corpus.queries);
+    for (auto _ : state) {
+        const Paginator pages(documents.begin(), documents.end(), PAGE_SIZE);
+        benchmark::DoNotOptimize(pages.size());
+    }
+    state.SetItemsProcessed(state.iterations() * documents.size());
+}
+
+void RegisterBenchmarks(size_t max_document_count) {
+    const auto register_sizes = [max_document_count](benchmark::internal::Benchmark* benchmark) {
+        for (size_t document_count = 1'000; document_count <= max_document_count; document_count *= 10) {
+            benchmark->Arg(static_cast<int64_t>(document_count));
+        }
+        benchmark->Unit(benchmark::kMicrosecond);
+    };
+    register_sizes(benchmark::RegisterBenchmark("AddDocument", AddDocumentBenchmark));
+    register_sizes(benchmark::RegisterBenchmark("AddDocuments", AddDocumentsBenchmark)->UseRealTime());
+    register_sizes(benchmark::RegisterBenchmark("FindTopDocuments/seq",
+        [](benchmark::State& state) {
+            FindTopDocumentsBenchmark(state, execution::seq);
+        }
+    ));
+    register_sizes(benchmark::RegisterBenchmark("FindTopDocuments/par",
+        [](benchmark::State& state) {
+            FindTopDocumentsBenchmark(state, execution::par);
+        }
+    )->UseRealTime());
+    register_sizes(benchmark::RegisterBenchmark("MatchDocument", MatchDocumentBenchmark));
+    register_sizes(benchmark::RegisterBenchmark("MatchDocuments", MatchDocumentsBenchmark)->UseRealTime());
+    register_sizes(benchmark::RegisterBenchmark("RemoveDocument", RemoveDocumentBenchmark));
+    register_sizes(benchmark::RegisterBenchmark("ProcessQueries", ProcessQueriesBenchmark)->UseRealTime());
+    register_sizes(benchmark::RegisterBenchmark("Paginator", PaginatorBenchmark));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // --max_documents=N is read here, the other flags go to Google Benchmark
+    static constexpr string_view MAX_DOCUMENTS_FLAG = "--max_documents="sv;
+    size_t max_document_count = 100'000;
+    int kept_argc = 0;
+    for (int i = 0; i < argc; ++i) {
+        const string_view arg = argv[i];
+        if (arg.substr(0, MAX_DOCUMENTS_FLAG.size()) == MAX_DOCUMENTS_FLAG) {
+            max_document_count = strtoull(argv[i] + MAX_DOCUMENTS_FLAG.size(), nullptr, 10);
+        }
+        else {
+            argv[kept_argc++] = argv[i];
+        }
+    }
+    argc = kept_argc;
+
+    benchmark::AddCustomContext("seed", to_string(SEED));
+    benchmark::AddCustomContext("max_documents", to_string(max_document_count));
+    RegisterBenchmarks(max_document_count);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+}
@@ -0,0 +1,94 @@
+#include "search_server.h"
+#include "segmented_search_server.h"
+#include "log_duration.h"
+#include "generators.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Adds the documents one by one and prints the longest AddDocument call
+template <typename Server>
+void AddDocuments(const string& mark, Server& search_server, const vector<string>& documents) {
+    LOG_DURATION(mark + " AddDocument"s);
+    chrono::steady_clock::duration max_duration{};
+    for (size_t i = 0; i < documents.size(); ++i) {
+        const auto start_time = chrono::steady_clock::now();
+        search_server.AddDocument(i, documents[i], DocumentStatus::ACTUAL, { static_cast<int>(i % 7) });
+        max_duration = max(max_duration, chrono::steady_clock::now() - start_time);
+    }
+    cout << mark << " longest AddDocument: "s
+        << chrono::duration_cast<chrono::microseconds>(max_duration).count() << " us"s << endl;
+}
+
+template <typename Server>
+vector<vector<Document>> FindAll(const string& mark, const Server& search_server, const vector<string>& queries) {
+    LOG_DURATION(mark + " FindTopDocuments"s);
+    vector<vector<Document>> results;
+    for (const string& query : queries) {
+        results.push_back(search_server.FindTopDocuments(query));
+    }
+    return results;
+}
+
+// Documents with equal relevance may come in another order
+bool HaveSameRelevances(const vector<vector<Document>>& lhs, const vector<vector<Document>>& rhs) {
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        if (lhs[i].size() != rhs[i].size()) {
+            return false;
+        }
+        for (size_t j = 0; j < lhs[i].size(); ++j) {
+            if (abs(lhs[i][j].relevance - rhs[i][j].relevance) > eps) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Usage: segmented_index_benchmark [document_count] [removed_share]
+int main(int argc, char* argv[]) {
+    const int document_count = argc > 1 ? atoi(argv[1]) : 50'000;
+    const double removed_share = argc > 2 ? atof(argv[2]) : 0.5;
+
+    mt19937 generator;
+    const auto dictionary = GenerateDictionary(generator, 1000, 10);
+    const auto documents = GenerateQueries(generator, dictionary, document_count, 30);
+    const auto queries = GenerateQueries(generator, dictionary, 200, 5);
+
+    SearchServer search_server(dictionary[0]);
+    SegmentedSearchServer segmented_server(dictionary[0]);
+    AddDocuments("single"s, search_server, documents);
+    AddDocuments("segmented"s, segmented_server, documents);
+    segmented_server.WaitForMerges();
+    cout << "segments: "s << segmented_server.GetSegmentCount() << endl;
+
+    const auto single_results = FindAll("single"s, search_server, queries);
+    const auto segmented_results = FindAll("segmented"s, segmented_server, queries);
+    cout << (HaveSameRelevances(single_results, segmented_results) ? "results match"s : "RESULTS DIFFER"s) << endl;
+
+    const int removed_count = static_cast<int>(document_count * removed_share);
+    {
+        LOG_DURATION("single RemoveDocument"s);
+        for (int i = 0; i < removed_count; ++i) {
+            search_server.RemoveDocument(execution::seq, i);
+        }
+    }
+    {
+        LOG_DURATION("segmented RemoveDocument"s);
+        for (int i = 0; i < removed_count; ++i) {
+            segmented_server.RemoveDocument(i);
+        }
+    }
+    segmented_server.WaitForMerges();
+    cout << "segments after removal: "s << segmented_server.GetSegmentCount() << endl;
+    const auto single_left = FindAll("single"s, search_server, queries);
+    const auto segmented_left = FindAll("segmented"s, segmented_server, queries);
+    cout << (HaveSameRelevances(single_left, segmented_left) ? "results match"s : "RESULTS DIFFER"s) << endl;
+}
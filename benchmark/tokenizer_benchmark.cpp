@@ -0,0 +1,84 @@
+#include "string_processing.h"
+#include "generators.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// SplitIntoWords and the IsValidWord check as they were before SplitIntoValidWords
+vector<string_view> SplitIntoWordsReference(string_view str) {
+    vector<string_view> result;
+    while (true) {
+        const size_t space = str.find(' ');
+        result.push_back(space == str.npos ? str : str.substr(0, space));
+        if (space == str.npos) {
+            break;
+        }
+        str.remove_prefix(space + 1);
+    }
+    return result;
+}
+
+bool IsValidWordReference(string_view word) {
+    return none_of(word.begin(), word.end(), [](char c) {
+        return c >= '\0' && c < ' ';
+    });
+}
+
+template <typename Function>
+void Measure(const string& name, const vector<string>& texts, int repeat_count, Function split) {
+    size_t byte_count = 0;
+    size_t word_count = 0;
+    const auto start = chrono::steady_clock::now();
+    for (int i = 0; i < repeat_count; ++i) {
+        for (const string& text : texts) {
+            word_count += split(text);
+            byte_count += text.size();
+        }
+    }
+    const chrono::duration<double> duration = chrono::steady_clock::now() - start;
+    cout << name << ": "s << byte_count / duration.count() / (1 << 20) << " MB/s ("s
+        << word_count << " words)"s << endl;
+}
+
+void Run(const string& name, const vector<string>& texts, int repeat_count) {
+    Measure(name + " reference"s, texts, repeat_count, [](const string& text) {
+        const auto words = SplitIntoWordsReference(text);
+        return all_of(words.begin(), words.end(), IsValidWordReference) ? words.size() : 0;
+    });
+    vector<string_view> words;
+    Measure(name + " SplitIntoValidWords"s, texts, repeat_count, [&words](const string& text) {
+        return SplitIntoValidWords(text, words) == string_view::npos ? words.size() : 0;
+    });
+}
+
+// Usage: tokenizer_benchmark [megabytes]
+int main(int argc, char* argv[]) {
+    const size_t megabyte_count = argc > 1 ? atoi(argv[1]) : 64;
+
+    mt19937 generator;
+    const auto dictionary = GenerateDictionary(generator, 10'000, 10);
+
+    vector<string> documents;
+    size_t total_size = 0;
+    while (total_size < (megabyte_count << 20)) {
+        documents.push_back(GenerateQuery(generator, dictionary, 70));
+        total_size += documents.back().size();
+    }
+    Run("documents of 70 words"s, documents, 1);
+
+    string text;
+    text.reserve(total_size + documents.size());
+    for (const string& document : documents) {
+        text += document;
+        text += ' ';
+    }
+    Run("single text"s, { text }, 1);
+}
@@ -0,0 +1,438 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// Occurrences of a term in a document
+struct PostingCount {
+    int document_id;
+    uint32_t count;
+};
+
+// Posting list sorted by document_id that packs postings into blocks of
+// BLOCK_SIZE: the differences between neighbouring document ids and the
+// counts are bit-packed, each with the bit width its block needs.
+// The last postings stay unpacked until they fill a block.
+// A removed posting keeps its id with a zero count and is dropped by
+// Compact(), which runs automatically once they make up half of the list.
+class CompressedPostingList {
+public:
+    static constexpr size_t BLOCK_SIZE = 128;
+
+    // Walks the postings in document_id order, skipping ahead on request.
+    // Whole blocks are skipped by their last document ids without decoding
+    class Cursor {
+    public:
+        explicit Cursor(const CompressedPostingList& postings)
+            : postings_(&postings) {
+            LoadBlock(0);
+            SkipRemoved();
+        }
+
+        bool AtEnd() const {
+            return position_ == size_;
+        }
+
+        int GetDocumentId() const {
+            return document_ids_[position_];
+        }
+
+        uint32_t GetCount() const {
+            return counts_[position_];
+        }
+
+        void Next() {
+            Step();
+            SkipRemoved();
+        }
+
+        // Moves to the first posting with document_id >= target
+        void Advance(int target) {
+            if (AtEnd() || GetDocumentId() >= target) {
+                return;
+            }
+            const auto& blocks = postings_->blocks_;
+            if (block_ < blocks.size() && blocks[block_].last_document_id < target) {
+                const auto block_it = std::lower_bound(blocks.begin() + block_ + 1, blocks.end(), target,
+                    [](const Block& block, int id) {
+                        return block.last_document_id < id;
+                    }
+                );
+                LoadBlock(block_it - blocks.begin());
+            }
+            position_ = std::lower_bound(document_ids_ + position_, document_ids_ + size_, target) - document_ids_;
+            if (position_ == size_ && block_ < blocks.size()) {
+                LoadBlock(block_ + 1);
+            }
+            SkipRemoved();
+        }
+
+    private:
+        // Block index blocks_.size() stands for the tail
+        void LoadBlock(size_t block) {
+            block_ = block;
+            position_ = 0;
+            if (block < postings_->blocks_.size()) {
+                postings_->DecodeBlock(postings_->blocks_[block], document_ids_, counts_);
+                size_ = BLOCK_SIZE;
+            }
+            else {
+                size_ = postings_->tail_.size();
+                for (size_t i = 0; i < size_; ++i) {
+                    document_ids_[i] = postings_->tail_[i].document_id;
+                    counts_[i] = postings_->tail_[i].count;
+                }
+            }
+        }
+
+        void Step() {
+            ++position_;
+            if (position_ == size_ && block_ < postings_->blocks_.size()) {
+                LoadBlock(block_ + 1);
+            }
+        }
+
+        void SkipRemoved() {
+            while (!AtEnd() && counts_[position_] == 0) {
+                Step();
+            }
+        }
+
+        const CompressedPostingList* postings_;
+        size_t block_ = 0;
+        size_t position_ = 0;
+        size_t size_ = 0;
+        int document_ids_[BLOCK_SIZE];
+        uint32_t counts_[BLOCK_SIZE];
+    };
+
+    size_t StoredCount() const {
+        return blocks_.size() * BLOCK_SIZE + tail_.size();
+    }
+
+    size_t size() const {
+        return StoredCount() - removed_count_;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    size_t MemoryUsage() const {
+        return blocks_.capacity() * sizeof(Block) + words_.capacity() * sizeof(uint32_t)
+            + tail_.capacity() * sizeof(PostingCount);
+    }
+
+    // Calls function(document_id, count) for the postings stored at positions
+    // [first, last) that are not removed. first must be a multiple of BLOCK_SIZE
+    template <typename Function>
+    void ForEach(size_t first, size_t last, Function function) const {
+        int document_ids[BLOCK_SIZE];
+        uint32_t counts[BLOCK_SIZE];
+        for (size_t block = first / BLOCK_SIZE; block < blocks_.size() && block * BLOCK_SIZE < last; ++block) {
+            DecodeBlock(blocks_[block], document_ids, counts);
+            const size_t block_last = std::min(BLOCK_SIZE, last - block * BLOCK_SIZE);
+            for (size_t i = 0; i < block_last; ++i) {
+                if (counts[i] != 0) {
+                    function(document_ids[i], counts[i]);
+                }
+            }
+        }
+        const size_t tail_begin = blocks_.size() * BLOCK_SIZE;
+        for (size_t position = std::max(first, tail_begin); position < last; ++position) {
+            const auto& posting = tail_[position - tail_begin];
+            if (posting.count != 0) {
+                function(posting.document_id, posting.count);
+            }
+        }
+    }
+
+    // Adds count to the posting of document_id, creating it if needed
+    void Add(int document_id, uint32_t count) {
+        if (GetLastDocumentId() < document_id) {
+            Append({ document_id, count });
+            return;
+        }
+        auto postings = Decode();
+        auto it = LowerBound(postings, document_id);
+        if (it != postings.end() && it->document_id == document_id) {
+            it->count += count;
+        }
+        else {
+            postings.insert(it, { document_id, count });
+        }
+        Assign(postings);
+    }
+
+    // Adds postings of documents the list does not contain yet.
+    // new_postings must be sorted by document_id
+    void Merge(const std::vector<PostingCount>& new_postings) {
+        if (new_postings.empty()) {
+            return;
+        }
+        if (GetLastDocumentId() < new_postings.front().document_id) {
+            for (const auto& posting : new_postings) {
+                Append(posting);
+            }
+            return;
+        }
+        const auto postings = Decode();
+        std::vector<PostingCount> merged;
+        merged.reserve(postings.size() + new_postings.size());
+        auto it = postings.begin();
+        for (const auto& posting : new_postings) {
+            while (it != postings.end() && it->document_id < posting.document_id) {
+                merged.push_back(*it++);
+            }
+            if (it != postings.end() && it->document_id == posting.document_id) {
+                // Only a removed posting can have the id of a new document
+                ++it;
+            }
+            merged.push_back(posting);
+        }
+        merged.insert(merged.end(), it, postings.end());
+        Assign(merged);
+    }
+
+    bool Remove(int document_id) {
+        const auto [block, position] = Find(document_id);
+        if (position == NOT_FOUND) {
+            return false;
+        }
+        if (block == blocks_.size()) {
+            tail_[position].count = 0;
+        }
+        else {
+            // Zero fits any bit width, so the count is cleared in place
+            const Block& packed = blocks_[block];
+            WriteBits(packed.offset + packed.delta_bits * BLOCK_SIZE / 32, packed.count_bits, position, 0);
+        }
+        ++removed_count_;
+        if (removed_count_ * 2 >= StoredCount()) {
+            Compact();
+        }
+        return true;
+    }
+
+    // Removes the postings of document_ids, which must be sorted. Many of them are
+    // dropped by repacking the list once, which drops the removed postings too
+    void RemoveAll(const std::vector<int>& document_ids) {
+        if (document_ids.size() * SEPARATE_REMOVAL_RATIO < StoredCount()) {
+            for (const int document_id : document_ids) {
+                Remove(document_id);
+            }
+            return;
+        }
+        auto postings = Decode();
+        auto id_it = document_ids.begin();
+        postings.erase(std::remove_if(postings.begin(), postings.end(),
+            [&id_it, &document_ids](const PostingCount& posting) {
+                id_it = std::lower_bound(id_it, document_ids.end(), posting.document_id);
+                return posting.count == 0 || (id_it != document_ids.end() && *id_it == posting.document_id);
+            }
+        ), postings.end());
+        Assign(postings);
+    }
+
+    bool Contains(int document_id) const {
+        return Find(document_id).second != NOT_FOUND;
+    }
+
+    void Compact() {
+        if (removed_count_ == 0) {
+            return;
+        }
+        auto postings = Decode();
+        postings.erase(std::remove_if(postings.begin(), postings.end(),
+            [](const PostingCount& posting) {
+                return posting.count == 0;
+            }
+        ), postings.end());
+        removed_count_ = 0;
+        Assign(postings);
+    }
+
+    // Gives every posting that is not removed the id new_ids[document_id] and drops
+    // the removed ones. The new ids must be in the same order as the old ones
+    void Renumber(const std::vector<uint32_t>& new_ids) {
+        auto postings = Decode();
+        size_t size = 0;
+        for (const auto& posting : postings) {
+            if (posting.count != 0) {
+                postings[size++] = { static_cast<int>(new_ids[posting.document_id]), posting.count };
+            }
+        }
+        postings.resize(size);
+        Assign(postings);
+    }
+
+private:
+    static constexpr size_t NOT_FOUND = BLOCK_SIZE;
+    // RemoveAll clears postings one by one if the list is this many times longer
+    static constexpr size_t SEPARATE_REMOVAL_RATIO = 16;
+
+    struct Block {
+        int first_document_id;
+        int last_document_id;
+        // Position of the packed differences in words_, the counts follow them
+        uint32_t offset;
+        uint8_t delta_bits;
+        uint8_t count_bits;
+    };
+
+    static uint8_t GetBitWidth(uint32_t value) {
+        uint8_t bits = 0;
+        for (; value != 0; value >>= 1) {
+            ++bits;
+        }
+        return bits;
+    }
+
+    // Reads value index of the bit width bits packed from words_[offset]
+    uint32_t ReadBits(size_t offset, uint8_t bits, size_t index) const {
+        const size_t bit_position = index * bits;
+        uint64_t window;
+        // words_ ends with a spare word, so two words can always be read
+        std::memcpy(&window, &words_[offset + bit_position / 32], sizeof(window));
+        return static_cast<uint32_t>((window >> (bit_position % 32)) & ((uint64_t(1) << bits) - 1));
+    }
+
+    void WriteBits(size_t offset, uint8_t bits, size_t index, uint32_t value) {
+        const size_t bit_position = index * bits;
+        uint64_t window;
+        std::memcpy(&window, &words_[offset + bit_position / 32], sizeof(window));
+        const uint64_t mask = ((uint64_t(1) << bits) - 1) << (bit_position % 32);
+        window = (window & ~mask) | (uint64_t(value) << (bit_position % 32));
+        std::memcpy(&words_[offset + bit_position / 32], &window, sizeof(window));
+    }
+
+    void DecodeBlock(const Block& block, int* document_ids, uint32_t* counts) const {
+        const size_t count_offset = block.offset + block.delta_bits * BLOCK_SIZE / 32;
+        int document_id = block.first_document_id;
+        for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+            document_id += static_cast<int>(ReadBits(block.offset, block.delta_bits, i));
+            document_ids[i] = document_id;
+            counts[i] = ReadBits(count_offset, block.count_bits, i);
+        }
+    }
+
+    // Packs tail_, which holds BLOCK_SIZE postings, into a new block
+    void PackTail() {
+        Block block{ tail_.front().document_id, tail_.back().document_id, 0, 0, 0 };
+        uint32_t max_delta = 0;
+        uint32_t max_count = 0;
+        for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+            if (i > 0) {
+                max_delta = std::max(max_delta, static_cast<uint32_t>(tail_[i].document_id - tail_[i - 1].document_id));
+            }
+            max_count = std::max(max_count, tail_[i].count);
+        }
+        block.delta_bits = GetBitWidth(max_delta);
+        // At least one bit, so that a count can be cleared in place
+        block.count_bits = std::max<uint8_t>(1, GetBitWidth(max_count));
+
+        // Each value takes bits bits, so BLOCK_SIZE values take bits * BLOCK_SIZE / 32 words
+        if (!words_.empty()) {
+            words_.pop_back();
+        }
+        block.offset = static_cast<uint32_t>(words_.size());
+        words_.resize(words_.size() + (block.delta_bits + block.count_bits) * BLOCK_SIZE / 32 + 1);
+        const size_t count_offset = block.offset + block.delta_bits * BLOCK_SIZE / 32;
+        for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+            if (i > 0) {
+                WriteBits(block.offset, block.delta_bits, i, tail_[i].document_id - tail_[i - 1].document_id);
+            }
+            WriteBits(count_offset, block.count_bits, i, tail_[i].count);
+        }
+        blocks_.push_back(block);
+        tail_.clear();
+    }
+
+    void Append(const PostingCount& posting) {
+        tail_.push_back(posting);
+        if (posting.count == 0) {
+            ++removed_count_;
+        }
+        if (tail_.size() == BLOCK_SIZE) {
+            PackTail();
+        }
+    }
+
+    int GetLastDocumentId() const {
+        if (!tail_.empty()) {
+            return tail_.back().document_id;
+        }
+        return blocks_.empty() ? -1 : blocks_.back().last_document_id;
+    }
+
+    // All postings, removed ones included
+    std::vector<PostingCount> Decode() const {
+        std::vector<PostingCount> postings;
+        postings.reserve(StoredCount());
+        int document_ids[BLOCK_SIZE];
+        uint32_t counts[BLOCK_SIZE];
+        for (const Block& block : blocks_) {
+            DecodeBlock(block, document_ids, counts);
+            for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+                postings.push_back({ document_ids[i], counts[i] });
+            }
+        }
+        postings.insert(postings.end(), tail_.begin(), tail_.end());
+        return postings;
+    }
+
+    void Assign(const std::vector<PostingCount>& postings) {
+        blocks_.clear();
+        words_.clear();
+        tail_.clear();
+        removed_count_ = 0;
+        for (const auto& posting : postings) {
+            Append(posting);
+        }
+    }
+
+    static std::vector<PostingCount>::iterator LowerBound(std::vector<PostingCount>& postings, int document_id) {
+        return std::lower_bound(postings.begin(), postings.end(), document_id,
+            [](const PostingCount& posting, int id) {
+                return posting.document_id < id;
+            }
+        );
+    }
+
+    // Returns the block of the posting of document_id (blocks_.size() for
+    // the tail) and its position there, or NOT_FOUND if it is absent or removed
+    std::pair<size_t, size_t> Find(int document_id) const {
+        const auto block_it = std::lower_bound(blocks_.begin(), blocks_.end(), document_id,
+            [](const Block& block, int id) {
+                return block.last_document_id < id;
+            }
+        );
+        const size_t block = block_it - blocks_.begin();
+        if (block_it == blocks_.end()) {
+            const auto it = std::lower_bound(tail_.begin(), tail_.end(), document_id,
+                [](const PostingCount& posting, int id) {
+                    return posting.document_id < id;
+                }
+            );
+            const bool found = it != tail_.end() && it->document_id == document_id && it->count != 0;
+            return { block, found ? static_cast<size_t>(it - tail_.begin()) : NOT_FOUND };
+        }
+        int document_ids[BLOCK_SIZE];
+        uint32_t counts[BLOCK_SIZE];
+        DecodeBlock(*block_it, document_ids, counts);
+        const int* it = std::lower_bound(document_ids, document_ids + BLOCK_SIZE, document_id);
+        const size_t position = it - document_ids;
+        const bool found = position < BLOCK_SIZE && *it == document_id && counts[position] != 0;
+        return { block, found ? position : NOT_FOUND };
+    }
+
+    std::vector<Block> blocks_;
+    // Packed bits of all blocks and one spare word
+    std::vector<uint32_t> words_;
+    std::vector<PostingCount> tail_;
+    size_t removed_count_ = 0;
+};
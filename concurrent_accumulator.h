@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+// Sums values by index from the dense range [0, size) from many threads at once.
+// Adds are lock-free, and an excluded index never shows up in ForEach,
+// whether it was added before or after the exclusion.
+// Add and Exclude report the first touch of an index, so a caller that collects
+// those indexes can read and reset just them and use the accumulator again
+template <typename Value>
+class ConcurrentAccumulator {
+public:
+    static_assert(std::is_arithmetic_v<Value>, "ConcurrentAccumulator supports only arithmetic values");
+
+    ConcurrentAccumulator() = default;
+
+    explicit ConcurrentAccumulator(size_t size)
+        : values_(new std::atomic<Value>[size]())
+        , states_(new std::atomic<uint8_t>[size]())
+        , size_(size) {
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    // Grows the range to at least size, dropping the sums. Must not run concurrently with anything else
+    void Reserve(size_t size) {
+        if (size > size_) {
+            *this = ConcurrentAccumulator(std::max(size, size_ * 2));
+        }
+    }
+
+    // Returns true if the index was untouched before
+    bool Add(size_t index, Value value) {
+        auto& state = states_[index];
+        uint8_t previous_state = state.load(std::memory_order_relaxed);
+        if ((previous_state & ADDED) == 0) {
+            previous_state = state.fetch_or(ADDED, std::memory_order_relaxed);
+        }
+        auto& sum = values_[index];
+        Value current = sum.load(std::memory_order_relaxed);
+        while (!sum.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {
+        }
+        return previous_state == 0;
+    }
+
+    // Returns true if the index was untouched before
+    bool Exclude(size_t index) {
+        return states_[index].fetch_or(EXCLUDED, std::memory_order_relaxed) == 0;
+    }
+
+    // Sees exclusions that happened before the caller was started, e.g. by an earlier ParallelFor
+    bool IsExcluded(size_t index) const {
+        return (states_[index].load(std::memory_order_relaxed) & EXCLUDED) != 0;
+    }
+
+    // Calls function(index, sum) in index order for every added and not excluded index,
+    // and makes every index untouched. Must not run concurrently with anything else
+    template <typename Function>
+    void ForEachAndResetAll(Function function) {
+        for (size_t index = 0; index < size_; ++index) {
+            const uint8_t state = states_[index].load(std::memory_order_relaxed);
+            if (state == 0) {
+                continue;
+            }
+            if (state == ADDED) {
+                function(index, values_[index].load(std::memory_order_relaxed));
+            }
+            values_[index].store(Value{}, std::memory_order_relaxed);
+            states_[index].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Calls function(index, sum) in the order of indexes for every one of them
+    // that was added and not excluded. Must not run concurrently with Add or Exclude.
+    template <typename Indexes, typename Function>
+    void ForEach(const Indexes& indexes, Function function) const {
+        for (const size_t index : indexes) {
+            if (states_[index].load(std::memory_order_relaxed) == ADDED) {
+                function(index, values_[index].load(std::memory_order_relaxed));
+            }
+        }
+    }
+
+    // Makes the indexes untouched. Must not run concurrently with anything else
+    template <typename Indexes>
+    void Reset(const Indexes& indexes) {
+        for (const size_t index : indexes) {
+            values_[index].store(Value{}, std::memory_order_relaxed);
+            states_[index].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void ResetAll() {
+        for (size_t index = 0; index < size_; ++index) {
+            values_[index].store(Value{}, std::memory_order_relaxed);
+            states_[index].store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static constexpr uint8_t ADDED = 1;
+    static constexpr uint8_t EXCLUDED = 2;
+
+    std::unique_ptr<std::atomic<Value>[]> values_;
+    std::unique_ptr<std::atomic<uint8_t>[]> states_;
+    size_t size_ = 0;
+};
+
+// The accumulator of the calling thread, which its queries take in turn, so that a query
+// pays for the indexes it touches instead of allocating and scanning the whole range.
+// The holder resets the touched indexes and calls MarkClean; if it does not, as when
+// the query throws, the whole accumulator is reset. A query that starts while another
+// one holds the accumulator of its thread gets a new one, as with QueryArena
+template <typename Value>
+class ThreadLocalAccumulator {
+public:
+    explicit ThreadLocalAccumulator(size_t size) {
+        thread_local Holder holder;
+        if (holder.in_use) {
+            accumulator_ = &own_.emplace(size);
+            return;
+        }
+        holder.in_use = true;
+        holder_ = &holder;
+        holder.accumulator.Reserve(size);
+        accumulator_ = &holder.accumulator;
+    }
+
+    ThreadLocalAccumulator(const ThreadLocalAccumulator&) = delete;
+    ThreadLocalAccumulator& operator=(const ThreadLocalAccumulator&) = delete;
+
+    ~ThreadLocalAccumulator() {
+        if (!holder_) {
+            return;
+        }
+        if (!clean_) {
+            holder_->accumulator.ResetAll();
+        }
+        holder_->in_use = false;
+    }
+
+    ConcurrentAccumulator<Value>& Get() {
+        return *accumulator_;
+    }
+
+    // Every touched index has been reset
+    void MarkClean() {
+        clean_ = true;
+    }
+
+private:
+    struct Holder {
+        ConcurrentAccumulator<Value> accumulator;
+        bool in_use = false;
+    };
+
+    Holder* holder_ = nullptr;
+    std::optional<ConcurrentAccumulator<Value>> own_;
+    ConcurrentAccumulator<Value>* accumulator_ = nullptr;
+    bool clean_ = false;
+};
@@ -0,0 +1,52 @@
+#include "concurrent_search_server.h"
+
+using std::vector;
+
+ConcurrentSearchServer::ReadGuard ConcurrentSearchServer::Read() const {
+    auto& reader_count = reader_counts_[reader_count_index_.load()];
+    reader_count.fetch_add(1);
+    return ReadGuard(servers_[active_server_.load()], reader_count);
+}
+
+int ConcurrentSearchServer::GetDocumentCount() const {
+    return Read()->GetDocumentCount();
+}
+
+void ConcurrentSearchServer::AddDocument(int document_id, std::string_view document,
+                                         DocumentStatus status, const vector<int>& ratings) {
+    Modify([&](SearchServer& server) {
+        server.AddDocument(document_id, document, status, ratings);
+    });
+}
+
+vector<DocumentError> ConcurrentSearchServer::AddDocuments(const vector<DocumentInput>& documents) {
+    vector<DocumentError> errors;
+    bool first_copy = true;
+    Modify([&](SearchServer& server) {
+        // Both copies fail on the same documents
+        auto copy_errors = server.AddDocuments(documents);
+        if (first_copy) {
+            errors = std::move(copy_errors);
+            first_copy = false;
+        }
+    });
+    return errors;
+}
+
+void ConcurrentSearchServer::RemoveDocument(int document_id) {
+    Modify([document_id](SearchServer& server) {
+        server.RemoveDocument(document_id);
+    });
+}
+
+void ConcurrentSearchServer::RemoveDocuments(const vector<int>& document_ids) {
+    Modify([&document_ids](SearchServer& server) {
+        server.RemoveDocuments(document_ids);
+    });
+}
+
+void ConcurrentSearchServer::WaitForReaders(size_t reader_count_index) const {
+    while (reader_counts_[reader_count_index].load() != 0) {
+        std::this_thread::yield();
+    }
+}
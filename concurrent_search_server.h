@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <execution>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "document.h"
+#include "search_server.h"
+
+// Two copies of a SearchServer kept in step by the left-right technique.
+// Readers take whichever copy is active and never wait. A writer changes the
+// other copy, makes it active, waits until the readers of the old copy leave
+// and changes that copy too. Writers wait for each other, and the index takes twice the memory
+class ConcurrentSearchServer {
+public:
+    // A copy of the server that is not changed while the guard lives
+    class ReadGuard {
+    public:
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        ~ReadGuard() {
+            reader_count_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+
+        const SearchServer& operator*() const {
+            return server_;
+        }
+
+        const SearchServer* operator->() const {
+            return &server_;
+        }
+
+    private:
+        friend class ConcurrentSearchServer;
+
+        ReadGuard(const SearchServer& server, std::atomic<size_t>& reader_count)
+            : server_(server)
+            , reader_count_(reader_count) {
+        }
+
+        const SearchServer& server_;
+        std::atomic<size_t>& reader_count_;
+    };
+
+    // Both copies are built from the same arguments as a SearchServer
+    template <typename... Args>
+    explicit ConcurrentSearchServer(const Args&... args)
+        : servers_{ SearchServer(args...), SearchServer(args...) } {
+    }
+
+    ConcurrentSearchServer(const ConcurrentSearchServer&) = delete;
+    ConcurrentSearchServer& operator=(const ConcurrentSearchServer&) = delete;
+
+    ReadGuard Read() const;
+
+    template <typename... Args>
+    std::vector<Document> FindTopDocuments(const Args&... args) const {
+        return Read()->FindTopDocuments(args...);
+    }
+
+    int GetDocumentCount() const;
+
+    // Calls modify(SearchServer&) for both copies, one after the other. modify must
+    // change them the same way; if it throws for the first copy, it is not called for the second
+    template <typename Function>
+    void Modify(Function modify);
+
+    void AddDocument(int document_id, std::string_view document,
+        DocumentStatus status, const std::vector<int>& ratings);
+
+    std::vector<DocumentError> AddDocuments(const std::vector<DocumentInput>& documents);
+
+    void RemoveDocument(int document_id);
+
+    void RemoveDocuments(const std::vector<int>& document_ids);
+
+private:
+    void WaitForReaders(size_t reader_count_index) const;
+
+    SearchServer servers_[2];
+    // The copy new readers take
+    std::atomic<size_t> active_server_ = 0;
+    // Readers announce themselves in reader_counts_[reader_count_index_]
+    mutable std::atomic<size_t> reader_counts_[2] = { 0, 0 };
+    std::atomic<size_t> reader_count_index_ = 0;
+    std::mutex write_mutex_;
+};
+
+template <typename Function>
+void ConcurrentSearchServer::Modify(Function modify) {
+    std::lock_guard guard(write_mutex_);
+    const size_t active_server = active_server_.load();
+    modify(servers_[1 - active_server]);
+    active_server_.store(1 - active_server);
+
+    // Readers that may still use the old copy have registered in either counter:
+    // drain the idle one, send new readers there, then drain the other
+    const size_t reader_count_index = reader_count_index_.load();
+    WaitForReaders(1 - reader_count_index);
+    reader_count_index_.store(1 - reader_count_index);
+    WaitForReaders(reader_count_index);
+
+    modify(servers_[active_server]);
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
 
 struct Document {
     Document() = default;
@@ -18,4 +22,32 @@ enum class DocumentStatus {
     IRRELEVANT,
     BANNED,
     REMOVED,
+};
+
+// Ratings from min to max inclusive
+struct RatingRange {
+    int min = std::numeric_limits<int>::min();
+    int max = std::numeric_limits<int>::max();
+};
+
+// One document of a SearchServer::AddDocuments batch
+struct DocumentInput {
+    int id = 0;
+    std::string_view text;
+    DocumentStatus status = DocumentStatus::ACTUAL;
+    std::vector<int> ratings;
+};
+
+// A batch document that was not added, position is its index in the batch
+struct DocumentError {
+    size_t position = 0;
+    int document_id = 0;
+    std::string message;
+};
+
+// Results of a batch of queries in one buffer: query i found
+// documents[offsets[i]] up to documents[offsets[i + 1]]
+struct QueryBatchResults {
+    std::vector<Document> documents;
+    std::vector<size_t> offsets;
 };
\ No newline at end of file
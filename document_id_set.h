@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Set of non-negative document ids, kept as bitmaps of BLOCK_SIZE ids each like the
+// bitmap containers of a roaring bitmap. Membership takes two array reads,
+// and a block of ids the set does not have takes one null pointer
+class DocumentIdSet {
+public:
+    static constexpr size_t BLOCK_SIZE = size_t{ 1 } << 16;
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    bool Contains(int document_id) const {
+        const size_t block_index = static_cast<size_t>(document_id) / BLOCK_SIZE;
+        if (block_index >= blocks_.size() || blocks_[block_index] == nullptr) {
+            return false;
+        }
+        const size_t bit = static_cast<size_t>(document_id) % BLOCK_SIZE;
+        return (blocks_[block_index]->words[bit / 64] >> (bit % 64) & 1) != 0;
+    }
+
+    void Insert(int document_id) {
+        const size_t block_index = static_cast<size_t>(document_id) / BLOCK_SIZE;
+        if (block_index >= blocks_.size()) {
+            blocks_.resize(block_index + 1);
+        }
+        if (blocks_[block_index] == nullptr) {
+            blocks_[block_index] = std::make_unique<Block>();
+        }
+        Block& block = *blocks_[block_index];
+        const size_t bit = static_cast<size_t>(document_id) % BLOCK_SIZE;
+        const uint64_t mask = uint64_t{ 1 } << (bit % 64);
+        if ((block.words[bit / 64] & mask) == 0) {
+            block.words[bit / 64] |= mask;
+            ++block.count;
+            ++size_;
+        }
+    }
+
+    void Erase(int document_id) {
+        const size_t block_index = static_cast<size_t>(document_id) / BLOCK_SIZE;
+        if (block_index >= blocks_.size() || blocks_[block_index] == nullptr) {
+            return;
+        }
+        Block& block = *blocks_[block_index];
+        const size_t bit = static_cast<size_t>(document_id) % BLOCK_SIZE;
+        const uint64_t mask = uint64_t{ 1 } << (bit % 64);
+        if ((block.words[bit / 64] & mask) != 0) {
+            block.words[bit / 64] &= ~mask;
+            --size_;
+            if (--block.count == 0) {
+                blocks_[block_index].reset();
+            }
+        }
+    }
+
+private:
+    struct Block {
+        uint64_t words[BLOCK_SIZE / 64] = {};
+        size_t count = 0;
+    };
+
+    std::vector<std::unique_ptr<Block>> blocks_;
+    size_t size_ = 0;
+};
@@ -0,0 +1,43 @@
+#include "document_table.h"
+
+uint32_t DocumentTable::Add(int document_id, int rating, DocumentStatus status, size_t word_count) {
+    const auto internal_id = static_cast<uint32_t>(document_ids_.size());
+    document_ids_.push_back(document_id);
+    ratings_.push_back(rating);
+    statuses_.push_back(static_cast<uint8_t>(status));
+    word_counts_.push_back(static_cast<uint32_t>(word_count));
+    internal_ids_.emplace(document_id, internal_id);
+    return internal_id;
+}
+
+void DocumentTable::Remove(uint32_t internal_id) {
+    internal_ids_.erase(document_ids_[internal_id]);
+    document_ids_[internal_id] = FREE_ID;
+}
+
+uint32_t DocumentTable::Find(int document_id) const {
+    const auto it = internal_ids_.find(document_id);
+    return it == internal_ids_.end() ? NO_DOCUMENT : it->second;
+}
+
+std::vector<uint32_t> DocumentTable::Renumber() {
+    std::vector<uint32_t> new_ids(document_ids_.size(), NO_DOCUMENT);
+    uint32_t new_id = 0;
+    for (uint32_t internal_id = 0; internal_id < document_ids_.size(); ++internal_id) {
+        if (!IsUsed(internal_id)) {
+            continue;
+        }
+        new_ids[internal_id] = new_id;
+        document_ids_[new_id] = document_ids_[internal_id];
+        ratings_[new_id] = ratings_[internal_id];
+        statuses_[new_id] = statuses_[internal_id];
+        word_counts_[new_id] = word_counts_[internal_id];
+        internal_ids_[document_ids_[new_id]] = new_id;
+        ++new_id;
+    }
+    document_ids_.resize(new_id);
+    ratings_.resize(new_id);
+    statuses_.resize(new_id);
+    word_counts_.resize(new_id);
+    return new_ids;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <vector>
+
+#include "document.h"
+
+// Ratings, statuses and word counts of documents in parallel arrays indexed by
+// internal ids, which the index uses instead of document ids.
+// New documents always get the next unused id, so their postings are appended
+// to the end of every posting list. The ids of removed documents are not given out
+// again until Renumber makes the ids dense once more
+class DocumentTable {
+public:
+    static constexpr uint32_t NO_DOCUMENT = std::numeric_limits<uint32_t>::max();
+
+    // Walks the document ids in increasing order
+    class ConstIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = const int&;
+
+        explicit ConstIterator(std::map<int, uint32_t>::const_iterator it)
+            : it_(it) {
+        }
+
+        reference operator*() const {
+            return it_->first;
+        }
+
+        pointer operator->() const {
+            return &it_->first;
+        }
+
+        ConstIterator& operator++() {
+            ++it_;
+            return *this;
+        }
+
+        ConstIterator operator++(int) {
+            auto copy = *this;
+            ++it_;
+            return copy;
+        }
+
+        bool operator==(const ConstIterator& other) const {
+            return it_ == other.it_;
+        }
+
+        bool operator!=(const ConstIterator& other) const {
+            return it_ != other.it_;
+        }
+
+    private:
+        std::map<int, uint32_t>::const_iterator it_;
+    };
+
+    ConstIterator begin() const {
+        return ConstIterator(internal_ids_.begin());
+    }
+
+    ConstIterator end() const {
+        return ConstIterator(internal_ids_.end());
+    }
+
+    size_t size() const {
+        return internal_ids_.size();
+    }
+
+    bool empty() const {
+        return internal_ids_.empty();
+    }
+
+    // Every internal id in use is below it
+    size_t GetInternalIdBound() const {
+        return document_ids_.size();
+    }
+
+    // Returns the internal id given to the document, which must be new
+    uint32_t Add(int document_id, int rating, DocumentStatus status, size_t word_count);
+
+    void Remove(uint32_t internal_id);
+
+    // Internal ids that removed documents left unused
+    size_t GetFreeCount() const {
+        return document_ids_.size() - internal_ids_.size();
+    }
+
+    // Gives the documents the ids [0, size()) in the order of their current ids.
+    // Returns the new id of every old one, NO_DOCUMENT for unused ones
+    std::vector<uint32_t> Renumber();
+
+    // Returns NO_DOCUMENT if there is no such document
+    uint32_t Find(int document_id) const;
+
+    bool IsUsed(uint32_t internal_id) const {
+        return document_ids_[internal_id] != FREE_ID;
+    }
+
+    int GetDocumentId(uint32_t internal_id) const {
+        return document_ids_[internal_id];
+    }
+
+    int GetRating(uint32_t internal_id) const {
+        return ratings_[internal_id];
+    }
+
+    DocumentStatus GetStatus(uint32_t internal_id) const {
+        return static_cast<DocumentStatus>(statuses_[internal_id]);
+    }
+
+    // Words of the document that are not stop words
+    size_t GetWordCount(uint32_t internal_id) const {
+        return word_counts_[internal_id];
+    }
+
+private:
+    static constexpr int FREE_ID = -1;
+
+    std::vector<int> document_ids_;
+    std::vector<int> ratings_;
+    std::vector<uint8_t> statuses_;
+    std::vector<uint32_t> word_counts_;
+    // Used only to look documents up by id and to list them in order
+    std::map<int, uint32_t> internal_ids_;
+};
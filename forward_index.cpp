@@ -0,0 +1,54 @@
+#include "forward_index.h"
+
+#include <utility>
+
+void ForwardIndex::Set(uint32_t internal_id, const std::vector<TermFrequency>& terms) {
+    if (internal_id >= ranges_.size()) {
+        ranges_.resize(internal_id + 1);
+    }
+    ReleaseRange(internal_id);
+    ranges_[internal_id] = { entries_.size(), terms.size() };
+    entries_.insert(entries_.end(), terms.begin(), terms.end());
+}
+
+void ForwardIndex::Remove(uint32_t internal_id) {
+    if (internal_id < ranges_.size()) {
+        ReleaseRange(internal_id);
+    }
+}
+
+void ForwardIndex::Renumber(const std::vector<uint32_t>& new_ids) {
+    std::vector<Range> ranges;
+    for (uint32_t internal_id = 0; internal_id < ranges_.size(); ++internal_id) {
+        if (ranges_[internal_id].size == 0) {
+            continue;
+        }
+        const uint32_t new_id = new_ids[internal_id];
+        if (new_id >= ranges.size()) {
+            ranges.resize(new_id + 1);
+        }
+        ranges[new_id] = ranges_[internal_id];
+    }
+    ranges_ = std::move(ranges);
+    Compact();
+}
+
+void ForwardIndex::ReleaseRange(uint32_t internal_id) {
+    free_count_ += ranges_[internal_id].size;
+    ranges_[internal_id] = {};
+    if (free_count_ > entries_.size() - free_count_) {
+        Compact();
+    }
+}
+
+void ForwardIndex::Compact() {
+    std::vector<TermFrequency> entries;
+    entries.reserve(entries_.size() - free_count_);
+    for (auto& range : ranges_) {
+        const size_t offset = entries.size();
+        entries.insert(entries.end(), entries_.begin() + range.offset, entries_.begin() + range.offset + range.size);
+        range.offset = offset;
+    }
+    entries_ = std::move(entries);
+    free_count_ = 0;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "term_dictionary.h"
+
+struct TermFrequency {
+    TermId term_id;
+    double term_freq;
+};
+
+// Terms of one document, sorted by term id
+class TermFrequencies {
+public:
+    TermFrequencies() = default;
+
+    TermFrequencies(const TermFrequency* begin, const TermFrequency* end)
+        : begin_(begin)
+        , end_(end) {
+    }
+
+    const TermFrequency* begin() const {
+        return begin_;
+    }
+
+    const TermFrequency* end() const {
+        return end_;
+    }
+
+    size_t size() const {
+        return end_ - begin_;
+    }
+
+    bool empty() const {
+        return begin_ == end_;
+    }
+
+private:
+    const TermFrequency* begin_ = nullptr;
+    const TermFrequency* end_ = nullptr;
+};
+
+// Terms of every document in one shared array, a contiguous range per document,
+// addressed by the internal ids of DocumentTable. Ranges of removed documents are
+// reclaimed once they take more space than the live ones.
+// Views stay valid until the next change of the index
+class ForwardIndex {
+public:
+    // Replaces the terms of the document. They must be sorted by term id and unique
+    void Set(uint32_t internal_id, const std::vector<TermFrequency>& terms);
+
+    void Remove(uint32_t internal_id);
+
+    // Moves the terms of every internal id to new_ids[internal_id].
+    // Ids without terms may be left out of new_ids
+    void Renumber(const std::vector<uint32_t>& new_ids);
+
+    // Empty if the document has no terms
+    TermFrequencies Get(uint32_t internal_id) const {
+        if (internal_id >= ranges_.size()) {
+            return {};
+        }
+        const auto& range = ranges_[internal_id];
+        return { entries_.data() + range.offset, entries_.data() + range.offset + range.size };
+    }
+
+private:
+    struct Range {
+        size_t offset = 0;
+        size_t size = 0;
+    };
+
+    // Entries of removed documents and of replaced terms
+    size_t free_count_ = 0;
+    std::vector<TermFrequency> entries_;
+    std::vector<Range> ranges_;
+
+    void ReleaseRange(uint32_t internal_id);
+
+    // Moves the live ranges to the front, in the order of internal ids
+    void Compact();
+};
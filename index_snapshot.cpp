@@ -0,0 +1,129 @@
+#include "index_snapshot.h"
+
+#include <filesystem>
+
+using namespace std::string_literals;
+
+uint64_t ComputeSnapshotChecksum(const char* data, size_t size, uint64_t checksum) {
+    for (size_t offset = 0; offset < size; offset += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + offset, sizeof(word));
+        checksum = (checksum ^ word) * 0x100000001b3ULL;
+    }
+    return checksum;
+}
+
+SnapshotWriter::SnapshotWriter(const std::string& path)
+    : path_(path)
+    , temporary_path_(path + ".tmp"s)
+    , output_(temporary_path_, std::ios::binary | std::ios::trunc)
+    , checksum_(ComputeSnapshotChecksum(nullptr, 0))
+{
+    if (!output_) {
+        throw std::runtime_error("Cannot create "s + temporary_path_);
+    }
+    // Reserve room for the header, it is written by Finish()
+    const SnapshotHeader header{};
+    output_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    buffer_.reserve(BUFFER_SIZE);
+}
+
+void SnapshotWriter::WriteBytes(std::string_view bytes) {
+    Append(bytes.data(), bytes.size());
+    Align();
+}
+
+void SnapshotWriter::Align() {
+    const size_t padding = (SNAPSHOT_ALIGNMENT - payload_size_ % SNAPSHOT_ALIGNMENT) % SNAPSHOT_ALIGNMENT;
+    const char zeros[SNAPSHOT_ALIGNMENT] = {};
+    Append(zeros, padding);
+}
+
+void SnapshotWriter::Finish() {
+    Align();
+    Flush();
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byte_order = SNAPSHOT_BYTE_ORDER;
+    header.payload_size = payload_size_;
+    header.checksum = checksum_;
+    output_.seekp(0);
+    output_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output_.close();
+    if (!output_) {
+        throw std::runtime_error("Cannot write "s + temporary_path_);
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary_path_, path_, error);
+    if (error) {
+        throw std::runtime_error("Cannot replace "s + path_ + ": "s + error.message());
+    }
+}
+
+void SnapshotWriter::Append(const char* data, size_t size) {
+    buffer_.append(data, size);
+    payload_size_ += size;
+    if (buffer_.size() >= BUFFER_SIZE) {
+        Flush();
+    }
+}
+
+void SnapshotWriter::Flush() {
+    // The checksum goes by whole words, the tail waits for the next flush
+    const size_t flushed_size = buffer_.size() - buffer_.size() % SNAPSHOT_ALIGNMENT;
+    checksum_ = ComputeSnapshotChecksum(buffer_.data(), flushed_size, checksum_);
+    output_.write(buffer_.data(), flushed_size);
+    buffer_.erase(0, flushed_size);
+}
+
+SnapshotReader::SnapshotReader(const char* data, size_t size) {
+    SnapshotHeader header;
+    if (size < sizeof(header)) {
+        throw std::runtime_error("Snapshot is truncated");
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Not a snapshot");
+    }
+    if (header.byte_order != SNAPSHOT_BYTE_ORDER) {
+        throw std::runtime_error("Snapshot has a different byte order");
+    }
+    if (header.version != SNAPSHOT_VERSION) {
+        throw std::runtime_error("Unsupported snapshot version "s + std::to_string(header.version));
+    }
+    if (header.payload_size != size - sizeof(header) || header.payload_size % SNAPSHOT_ALIGNMENT != 0) {
+        throw std::runtime_error("Snapshot is truncated");
+    }
+    data_ = data + sizeof(header);
+    size_ = header.payload_size;
+    if (ComputeSnapshotChecksum(data_, size_) != header.checksum) {
+        throw std::runtime_error("Snapshot checksum mismatch");
+    }
+}
+
+std::string_view SnapshotReader::ReadBytes(size_t size) {
+    if (size > size_ - position_) {
+        throw std::runtime_error("Snapshot is truncated");
+    }
+    const std::string_view bytes(Take(size), size);
+    Align();
+    return bytes;
+}
+
+void SnapshotReader::Align() {
+    position_ = std::min(size_, (position_ + SNAPSHOT_ALIGNMENT - 1) / SNAPSHOT_ALIGNMENT * SNAPSHOT_ALIGNMENT);
+}
+
+bool SnapshotReader::AtEnd() const {
+    return position_ == size_;
+}
+
+const char* SnapshotReader::Take(size_t size) {
+    if (size > size_ - position_) {
+        throw std::runtime_error("Snapshot is truncated");
+    }
+    const char* const data = data_ + position_;
+    position_ += size;
+    return data;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Binary snapshot of an index: a SnapshotHeader followed by the payload.
+// Every value of the payload is stored in host byte order at an offset
+// aligned to SNAPSHOT_ALIGNMENT, so arrays can be used in place once the
+// file is mapped into memory.
+constexpr char SNAPSHOT_MAGIC[8] = { 'S', 'R', 'C', 'H', 'I', 'D', 'X', '\0' };
+constexpr uint32_t SNAPSHOT_VERSION = 4;
+constexpr uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+constexpr size_t SNAPSHOT_ALIGNMENT = 8;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t payload_size;
+    uint64_t checksum;
+};
+
+// FNV-1a over 64-bit words; size must be a multiple of SNAPSHOT_ALIGNMENT
+uint64_t ComputeSnapshotChecksum(const char* data, size_t size, uint64_t checksum = 0xcbf29ce484222325ULL);
+
+// Writes a snapshot to a temporary file, computing the checksum on the way,
+// and moves it over the target file once it is complete. A mapping of the
+// previous file stays valid
+class SnapshotWriter {
+public:
+    // Throws std::runtime_error if the file cannot be created
+    explicit SnapshotWriter(const std::string& path);
+
+    template <typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void WriteArray(const T* values, size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Append(reinterpret_cast<const char*>(values), sizeof(T) * count);
+        Align();
+    }
+
+    void WriteBytes(std::string_view bytes);
+
+    // Pads the payload with zeros up to the next aligned offset
+    void Align();
+
+    // Flushes the payload, fills in the header and replaces the target file
+    void Finish();
+
+private:
+    static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+    void Append(const char* data, size_t size);
+
+    void Flush();
+
+    std::string path_;
+    std::string temporary_path_;
+    std::ofstream output_;
+    std::string buffer_;
+    uint64_t payload_size_ = 0;
+    uint64_t checksum_;
+};
+
+// Reads the payload of a snapshot held in memory. Every read is checked
+// against the payload bounds and throws std::runtime_error past them
+class SnapshotReader {
+public:
+    // Checks the header and the checksum of the whole snapshot
+    SnapshotReader(const char* data, size_t size);
+
+    template <typename T>
+    T Read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    // Returns the array in place, without copying it
+    template <typename T>
+    const T* ReadArray(size_t count) {
+        static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= SNAPSHOT_ALIGNMENT);
+        if (count > (size_ - position_) / sizeof(T)) {
+            throw std::runtime_error("Snapshot is truncated");
+        }
+        const T* values = reinterpret_cast<const T*>(Take(sizeof(T) * count));
+        Align();
+        return values;
+    }
+
+    std::string_view ReadBytes(size_t size);
+
+    void Align();
+
+    bool AtEnd() const;
+
+private:
+    const char* Take(size_t size);
+
+    const char* data_;
+    size_t size_;
+    size_t position_ = 0;
+};
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+struct Posting {
+    int document_id;
+    double term_freq;
+};
+
+// Contiguous list of postings sorted by document_id.
+// Removed postings are only marked and are dropped by Compact(),
+// which runs automatically once they make up half of the list.
+// The postings may also live outside the list (see AssignView).
+class PostingList {
+public:
+    class ConstIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Posting;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Posting*;
+        using reference = const Posting&;
+
+        ConstIterator(const Posting* current, const Posting* last)
+            : current_(current)
+            , last_(last) {
+            SkipRemoved();
+        }
+
+        reference operator*() const {
+            return *current_;
+        }
+
+        pointer operator->() const {
+            return current_;
+        }
+
+        ConstIterator& operator++() {
+            ++current_;
+            SkipRemoved();
+            return *this;
+        }
+
+        ConstIterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const ConstIterator& other) const {
+            return current_ == other.current_;
+        }
+
+        bool operator!=(const ConstIterator& other) const {
+            return current_ != other.current_;
+        }
+
+    private:
+        void SkipRemoved() {
+            while (current_ != last_ && IsRemoved(*current_)) {
+                ++current_;
+            }
+        }
+
+        const Posting* current_;
+        const Posting* last_;
+    };
+
+    // Walks the postings in document_id order, skipping ahead on request
+    class Cursor {
+    public:
+        explicit Cursor(const PostingList& postings)
+            : current_(postings.Data())
+            , last_(postings.Data() + postings.StoredCount()) {
+            SkipRemoved();
+        }
+
+        bool AtEnd() const {
+            return current_ == last_;
+        }
+
+        int GetDocumentId() const {
+            return current_->document_id;
+        }
+
+        double GetTermFreq() const {
+            return current_->term_freq;
+        }
+
+        void Next() {
+            ++current_;
+            SkipRemoved();
+        }
+
+        // Moves to the first posting with document_id >= target, galloping
+        // from the current one, so that short skips stay cheap
+        void Advance(int target) {
+            if (AtEnd() || current_->document_id >= target) {
+                return;
+            }
+            const size_t remaining = last_ - current_;
+            size_t bound = 1;
+            while (bound < remaining && current_[bound].document_id < target) {
+                bound *= 2;
+            }
+            current_ = std::lower_bound(current_ + bound / 2 + 1, current_ + std::min(bound + 1, remaining), target,
+                [](const Posting& posting, int id) {
+                    return posting.document_id < id;
+                }
+            );
+            SkipRemoved();
+        }
+
+    private:
+        void SkipRemoved() {
+            while (current_ != last_ && IsRemoved(*current_)) {
+                ++current_;
+            }
+        }
+
+        const Posting* current_;
+        const Posting* last_;
+    };
+
+    ConstIterator begin() const {
+        return { Data(), Data() + StoredCount() };
+    }
+
+    ConstIterator end() const {
+        return { Data() + StoredCount(), Data() + StoredCount() };
+    }
+
+    // Postings stored at positions [first, last) of the list, skipping removed ones.
+    // Positions run up to StoredCount(), so slices split the work evenly
+    struct Slice {
+        ConstIterator first;
+        ConstIterator last;
+
+        ConstIterator begin() const {
+            return first;
+        }
+
+        ConstIterator end() const {
+            return last;
+        }
+    };
+
+    Slice GetSlice(size_t first, size_t last) const {
+        const Posting* const slice_end = Data() + last;
+        return { { Data() + first, slice_end }, { slice_end, slice_end } };
+    }
+
+    size_t StoredCount() const {
+        return view_ != nullptr ? view_size_ : postings_.size();
+    }
+
+    size_t size() const {
+        return StoredCount() - removed_count_;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    // Bytes of postings the list owns or refers to
+    size_t MemoryUsage() const {
+        return view_ != nullptr ? view_size_ * sizeof(Posting) : postings_.capacity() * sizeof(Posting);
+    }
+
+    // Adds term_freq to the posting of document_id, creating it if needed
+    void Add(int document_id, double term_freq) {
+        Detach();
+        if (postings_.empty() || postings_.back().document_id < document_id) {
+            postings_.push_back({ document_id, term_freq });
+            return;
+        }
+        auto it = LowerBound(document_id);
+        if (it != postings_.end() && it->document_id == document_id) {
+            if (IsRemoved(*it)) {
+                it->term_freq = 0.0;
+                --removed_count_;
+            }
+            it->term_freq += term_freq;
+        }
+        else {
+            postings_.insert(it, { document_id, term_freq });
+        }
+    }
+
+    // Adds postings of documents the list does not contain yet, in one pass.
+    // new_postings must be sorted by document_id
+    void Merge(const std::vector<Posting>& new_postings) {
+        if (new_postings.empty()) {
+            return;
+        }
+        Detach();
+        if (postings_.empty() || postings_.back().document_id < new_postings.front().document_id) {
+            postings_.insert(postings_.end(), new_postings.begin(), new_postings.end());
+            return;
+        }
+        std::vector<Posting> merged;
+        merged.reserve(postings_.size() + new_postings.size());
+        auto it = postings_.begin();
+        for (const Posting& posting : new_postings) {
+            while (it != postings_.end() && it->document_id < posting.document_id) {
+                merged.push_back(*it++);
+            }
+            if (it != postings_.end() && it->document_id == posting.document_id) {
+                // Only a removed posting can have the id of a new document
+                --removed_count_;
+                ++it;
+            }
+            merged.push_back(posting);
+        }
+        merged.insert(merged.end(), it, postings_.end());
+        postings_ = std::move(merged);
+    }
+
+    bool Remove(int document_id) {
+        Detach();
+        auto it = LowerBound(document_id);
+        if (it == postings_.end() || it->document_id != document_id || IsRemoved(*it)) {
+            return false;
+        }
+        it->term_freq = REMOVED_TERM_FREQ;
+        ++removed_count_;
+        if (removed_count_ * 2 >= postings_.size()) {
+            Compact();
+        }
+        return true;
+    }
+
+    // Removes the postings of document_ids, which must be sorted. Many of them are
+    // dropped in one pass over the list, which drops the removed postings too
+    void RemoveAll(const std::vector<int>& document_ids) {
+        if (document_ids.size() * SEPARATE_REMOVAL_RATIO < StoredCount()) {
+            for (const int document_id : document_ids) {
+                Remove(document_id);
+            }
+            return;
+        }
+        Detach();
+        auto id_it = document_ids.begin();
+        postings_.erase(std::remove_if(postings_.begin(), postings_.end(),
+            [&id_it, &document_ids](const Posting& posting) {
+                id_it = std::lower_bound(id_it, document_ids.end(), posting.document_id);
+                return IsRemoved(posting) || (id_it != document_ids.end() && *id_it == posting.document_id);
+            }
+        ), postings_.end());
+        removed_count_ = 0;
+    }
+
+    bool Contains(int document_id) const {
+        const Posting* const last = Data() + StoredCount();
+        const Posting* const it = std::lower_bound(Data(), last, document_id,
+            [](const Posting& posting, int id) {
+                return posting.document_id < id;
+            }
+        );
+        return it != last && it->document_id == document_id && !IsRemoved(*it);
+    }
+
+    void Compact() {
+        if (removed_count_ == 0) {
+            return;
+        }
+        postings_.erase(std::remove_if(postings_.begin(), postings_.end(), IsRemoved), postings_.end());
+        removed_count_ = 0;
+    }
+
+    // Gives every posting that is not removed the id new_ids[document_id] and drops
+    // the removed ones. The new ids must be in the same order as the old ones
+    void Renumber(const std::vector<uint32_t>& new_ids) {
+        Detach();
+        size_t size = 0;
+        for (const Posting& posting : postings_) {
+            if (!IsRemoved(posting)) {
+                postings_[size++] = { static_cast<int>(new_ids[posting.document_id]), posting.term_freq };
+            }
+        }
+        postings_.resize(size);
+        removed_count_ = 0;
+    }
+
+    // Makes the list use postings owned by someone else, e.g. a mapped
+    // snapshot, which must outlive the list. postings must be sorted by
+    // document_id and contain no removed ones. The first change copies them
+    void AssignView(const Posting* postings, size_t count) {
+        postings_.clear();
+        postings_.shrink_to_fit();
+        removed_count_ = 0;
+        view_ = postings;
+        view_size_ = count;
+    }
+
+private:
+    static constexpr double REMOVED_TERM_FREQ = -1.0;
+    // RemoveAll marks postings one by one if the list is this many times longer
+    static constexpr size_t SEPARATE_REMOVAL_RATIO = 16;
+
+    const Posting* Data() const {
+        return view_ != nullptr ? view_ : postings_.data();
+    }
+
+    void Detach() {
+        if (view_ != nullptr) {
+            postings_.assign(view_, view_ + view_size_);
+            view_ = nullptr;
+            view_size_ = 0;
+        }
+    }
+
+    static bool IsRemoved(const Posting& posting) {
+        return posting.term_freq == REMOVED_TERM_FREQ;
+    }
+
+    std::vector<Posting>::iterator LowerBound(int document_id) {
+        return std::lower_bound(postings_.begin(), postings_.end(), document_id,
+            [](const Posting& posting, int id) {
+                return posting.document_id < id;
+            }
+        );
+    }
+
+    std::vector<Posting> postings_;
+    size_t removed_count_ = 0;
+    const Posting* view_ = nullptr;
+    size_t view_size_ = 0;
+};
@@ -10,28 +10,27 @@ std::vector<std::vector<Document>> ProcessQueries(
     const SearchServer& search_server,
     const std::vector<std::string>& queries)
 {
+    const auto results = search_server.FindTopDocumentsBatch(queries);
     std::vector<std::vector<Document>> search_results(queries.size());
-    transform(
-        std::execution::par,
-        queries.begin(), queries.end(),
-        search_results.begin(),
-        [&search_server](const std::string& query) {
-            return search_server.FindTopDocuments(query);
-        }
-    );
+    for (size_t i = 0; i < queries.size(); ++i) {
+        search_results[i].assign(results.documents.begin() + results.offsets[i],
+            results.documents.begin() + results.offsets[i + 1]);
+    }
 
     return search_results;
 }
 
-std::list<Document> ProcessQueriesJoined(
+std::vector<Document> ProcessQueriesJoined(
     const SearchServer& search_server,
     const std::vector<std::string>& queries)
 {
-    std::list<Document> all_finded_documents;
-    for (auto& documents : ProcessQueries(search_server, queries)) {
-        for (auto& document : documents) {
-            all_finded_documents.push_back(std::move(document));
-        }
-    }
-    return all_finded_documents;
+    return search_server.FindTopDocumentsBatch(queries).documents;
+}
+
+std::vector<std::vector<Document>> ProcessQueries(
+    const ConcurrentSearchServer& search_server,
+    const std::vector<std::string>& queries)
+{
+    const auto server = search_server.Read();
+    return ProcessQueries(*server, queries);
 }
\ No newline at end of file
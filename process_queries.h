@@ -1,16 +1,23 @@
 #pragma once
 
 #include "search_server.h"
+#include "concurrent_search_server.h"
 #include "document.h"
 
 #include <string>
 #include <vector>
-#include <list>
 
 std::vector<std::vector<Document>> ProcessQueries(
     const SearchServer& search_server,
     const std::vector<std::string>& queries);
 
-std::list<Document> ProcessQueriesJoined(
+// Documents of all queries, query after query, in one buffer
+std::vector<Document> ProcessQueriesJoined(
     const SearchServer& search_server,
+    const std::vector<std::string>& queries);
+
+// Every query of the batch reads the same copy of the index, documents
+// may be added and removed meanwhile
+std::vector<std::vector<Document>> ProcessQueries(
+    const ConcurrentSearchServer& search_server,
     const std::vector<std::string>& queries);
\ No newline at end of file
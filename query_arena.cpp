@@ -0,0 +1,63 @@
+#include "query_arena.h"
+
+#include <algorithm>
+
+namespace {
+    constexpr size_t INITIAL_BUFFER_SIZE = 16 * 1024;
+    // A thread keeps at most this much between queries; larger queries take the rest from the heap
+    constexpr size_t MAX_BUFFER_SIZE = 1024 * 1024;
+}
+
+QueryArena::QueryArena()
+    : buffer_(AcquireThreadBuffer())
+{
+    if (buffer_) {
+        resource_.emplace(buffer_->data.get(), buffer_->size, &overflow_);
+    }
+    else {
+        resource_.emplace(&overflow_);
+    }
+}
+
+QueryArena::~QueryArena() {
+    resource_.reset();
+    if (!buffer_) {
+        return;
+    }
+    if (overflow_.GetAllocatedSize() > 0 && buffer_->size < MAX_BUFFER_SIZE) {
+        buffer_->size = std::min(MAX_BUFFER_SIZE,
+            std::max(buffer_->size * 2, buffer_->size + overflow_.GetAllocatedSize()));
+        buffer_->data.reset(new std::byte[buffer_->size]);
+    }
+    buffer_->in_use = false;
+}
+
+std::pmr::memory_resource* QueryArena::GetResource() {
+    return &*resource_;
+}
+
+QueryArena::ThreadBuffer* QueryArena::AcquireThreadBuffer() {
+    thread_local ThreadBuffer buffer;
+    if (buffer.in_use) {
+        return nullptr;
+    }
+    if (!buffer.data) {
+        buffer.data.reset(new std::byte[INITIAL_BUFFER_SIZE]);
+        buffer.size = INITIAL_BUFFER_SIZE;
+    }
+    buffer.in_use = true;
+    return &buffer;
+}
+
+void* QueryArena::OverflowResource::do_allocate(size_t bytes, size_t alignment) {
+    allocated_size_ += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void QueryArena::OverflowResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+}
+
+bool QueryArena::OverflowResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+// Memory for the temporaries of one query. Every thread keeps a buffer that its
+// queries take in turn. A query that outgrows it gets the rest from the heap, and
+// the buffer is enlarged afterwards, up to a limit, so a thread that keeps running
+// similar queries stops allocating, while one huge query does not pin its memory to
+// the thread for good. A query that starts while another one holds the buffer of
+// its thread, as a task run by a waiting ParallelFor does, uses the heap
+class QueryArena {
+public:
+    QueryArena();
+
+    QueryArena(const QueryArena&) = delete;
+    QueryArena& operator=(const QueryArena&) = delete;
+
+    ~QueryArena();
+
+    std::pmr::memory_resource* GetResource();
+
+private:
+    // Heap memory taken when the buffer runs out, counted to size the next buffer
+    class OverflowResource : public std::pmr::memory_resource {
+    public:
+        size_t GetAllocatedSize() const {
+            return allocated_size_;
+        }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        size_t allocated_size_ = 0;
+    };
+
+    struct ThreadBuffer {
+        std::unique_ptr<std::byte[]> data;
+        size_t size = 0;
+        bool in_use = false;
+    };
+
+    // The buffer of the calling thread, or nullptr if a query holds it
+    static ThreadBuffer* AcquireThreadBuffer();
+
+    ThreadBuffer* buffer_;
+    OverflowResource overflow_;
+    std::optional<std::pmr::monotonic_buffer_resource> resource_;
+};
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "query_result_cache.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+QueryResultCache::QueryResultCache(size_t capacity, size_t shard_count) {
+    shard_count = std::max<size_t>(1, std::min(shard_count, capacity));
+    shard_capacity_ = (capacity + shard_count - 1) / shard_count;
+    shards_.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+std::optional<std::vector<Document>> QueryResultCache::Find(const std::string& key, uint64_t generation) {
+    auto& shard = GetShard(key);
+    std::lock_guard guard(shard.mutex);
+    const auto it = shard.positions.find(key);
+    if (it == shard.positions.end()) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    const auto entry = it->second;
+    if (entry->generation != generation) {
+        shard.positions.erase(it);
+        shard.entries.erase(entry);
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return entry->documents;
+}
+
+void QueryResultCache::Insert(std::string key, uint64_t generation, std::vector<Document> documents) {
+    if (shard_capacity_ == 0) {
+        return;
+    }
+    auto& shard = GetShard(key);
+    std::lock_guard guard(shard.mutex);
+    const auto it = shard.positions.find(key);
+    if (it != shard.positions.end()) {
+        // Another thread has found the same query, the newer generation wins
+        const auto entry = it->second;
+        if (entry->generation <= generation) {
+            entry->generation = generation;
+            entry->documents = std::move(documents);
+        }
+        shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+        return;
+    }
+    if (shard.entries.size() == shard_capacity_) {
+        shard.positions.erase(shard.entries.back().key);
+        shard.entries.pop_back();
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+    shard.entries.push_front({ std::move(key), generation, std::move(documents) });
+    shard.positions.emplace(shard.entries.front().key, shard.entries.begin());
+}
+
+QueryResultCacheStats QueryResultCache::GetStats() const {
+    return { hits_.load(std::memory_order_relaxed), misses_.load(std::memory_order_relaxed),
+        evictions_.load(std::memory_order_relaxed) };
+}
+
+QueryResultCache::Shard& QueryResultCache::GetShard(const std::string& key) {
+    return *shards_[std::hash<std::string>{}(key) % shards_.size()];
+}
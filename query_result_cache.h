@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "document.h"
+
+struct QueryResultCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    // Entries dropped to make room, stale entries are not counted
+    uint64_t evictions = 0;
+};
+
+// Results of FindTopDocuments by canonical query key, split into shards with
+// their own mutex and LRU list. Every result is stored with the index generation
+// it was found at, and is not returned for any other generation
+class QueryResultCache {
+public:
+    // capacity is the number of results kept by all shards together
+    explicit QueryResultCache(size_t capacity, size_t shard_count = 16);
+
+    QueryResultCache(const QueryResultCache&) = delete;
+    QueryResultCache& operator=(const QueryResultCache&) = delete;
+
+    std::optional<std::vector<Document>> Find(const std::string& key, uint64_t generation);
+
+    void Insert(std::string key, uint64_t generation, std::vector<Document> documents);
+
+    QueryResultCacheStats GetStats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        uint64_t generation;
+        std::vector<Document> documents;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        // Most recently used first
+        std::list<Entry> entries;
+        // Keys point into the strings of entries
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> positions;
+    };
+
+    Shard& GetShard(const std::string& key);
+
+    size_t shard_capacity_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<uint64_t> hits_ = 0;
+    std::atomic<uint64_t> misses_ = 0;
+    std::atomic<uint64_t> evictions_ = 0;
+};
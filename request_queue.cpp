@@ -5,10 +5,9 @@ using std::vector;
 
 RequestQueue::RequestQueue(const SearchServer& search_server) : search_server_(search_server) {}
 
+// The status overload of SearchServer can answer from its result cache
 vector<Document> RequestQueue::AddFindRequest(const string& raw_query, DocumentStatus status) {
-    return AddFindRequest(raw_query, [status](int document_id, DocumentStatus document_status, int rating) {
-        return document_status == status;
-        });
+    return AddResult(search_server_.FindTopDocuments(raw_query, status));
 }
 
 vector<Document> RequestQueue::AddFindRequest(const string& raw_query) {
@@ -17,4 +16,24 @@ vector<Document> RequestQueue::AddFindRequest(const string& raw_query) {
 
 uint64_t RequestQueue::GetNoResultRequests() const {
     return number_empty_answer_;
+}
+
+vector<Document> RequestQueue::AddResult(vector<Document> documents) {
+    ++time_;
+    if (requests_.size() == sec_in_day_) {
+        if (number_empty_answer_ > 0 && requests_.front().status_query_ == false) {
+            --number_empty_answer_;
+        }
+        requests_.pop_front();
+    }
+
+    if (documents.size() == 0) {
+        ++number_empty_answer_;
+        requests_.push_back({ time_, requests_.size(), false });
+    }
+    else {
+        requests_.push_back({ time_, requests_.size(), true });
+    }
+
+    return documents;
 }
\ No newline at end of file
@@ -18,6 +18,9 @@ public:
     uint64_t GetNoResultRequests() const;
 
 private:
+    // Records the result of a request and returns it
+    std::vector<Document> AddResult(std::vector<Document> documents);
+
     struct QueryResult {
         uint64_t time_query_;
         size_t count_query_;
@@ -33,22 +36,5 @@ private:
 template <typename DocumentPredicate>
 std::vector<Document> RequestQueue::AddFindRequest(const std::string& raw_query,
     DocumentPredicate document_predicate) {
-    ++time_;
-    if (requests_.size() == sec_in_day_) {
-        if (number_empty_answer_ > 0 && requests_.front().status_query_ == false) {
-            --number_empty_answer_;
-        }
-        requests_.pop_front();
-    }
-
-    auto documents = search_server_.FindTopDocuments(raw_query, document_predicate);
-    if (documents.size() == 0) {
-        ++number_empty_answer_;
-        requests_.push_back({ time_, requests_.size(), false });
-    }
-    else {
-        requests_.push_back({ time_, requests_.size(), true });
-    }
-
-    return documents;
+    return AddResult(search_server_.FindTopDocuments(raw_query, document_predicate));
 }
\ No newline at end of file
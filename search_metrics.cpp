@@ -0,0 +1,266 @@
+#include "search_metrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+
+using namespace std::literals;
+
+namespace {
+
+// Written only by the thread that holds it, so an increment is a load and a store
+struct ThreadMetrics {
+    struct StageCounts {
+        std::atomic<uint64_t> count = 0;
+        std::atomic<uint64_t> total = 0;
+        std::atomic<uint64_t> max = 0;
+        std::atomic<uint64_t> bucket_counts[LatencyHistogram::BUCKET_COUNT] = {};
+    };
+
+    StageCounts stages[METRIC_STAGE_COUNT];
+    std::atomic<uint64_t> counters[METRIC_COUNTER_COUNT] = {};
+    // A block outlives its thread, and the next new thread takes it over
+    bool in_use = false;
+};
+
+void Increase(std::atomic<uint64_t>& value, uint64_t delta) {
+    value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+class MetricsRegistry {
+public:
+    // Never destroyed: threads of a pool that outlives the first call, such as the
+    // default one, release their blocks after static objects are gone
+    static MetricsRegistry& Get() {
+        static auto* registry = new MetricsRegistry;
+        return *registry;
+    }
+
+    ThreadMetrics* Acquire() {
+        std::lock_guard guard(mutex_);
+        for (const auto& metrics : metrics_) {
+            if (!metrics->in_use) {
+                metrics->in_use = true;
+                return metrics.get();
+            }
+        }
+        metrics_.push_back(std::make_unique<ThreadMetrics>());
+        metrics_.back()->in_use = true;
+        return metrics_.back().get();
+    }
+
+    void Release(ThreadMetrics* metrics) {
+        std::lock_guard guard(mutex_);
+        metrics->in_use = false;
+    }
+
+    template <typename Function>
+    void ForEach(Function function) {
+        std::lock_guard guard(mutex_);
+        for (const auto& metrics : metrics_) {
+            function(*metrics);
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<std::unique_ptr<ThreadMetrics>> metrics_;
+};
+
+ThreadMetrics& GetThreadMetrics() {
+    struct Holder {
+        MetricsRegistry& registry = MetricsRegistry::Get();
+        ThreadMetrics* metrics = registry.Acquire();
+
+        ~Holder() {
+            registry.Release(metrics);
+        }
+    };
+    thread_local Holder holder;
+    return *holder.metrics;
+}
+
+} // namespace
+
+std::string_view GetMetricName(MetricStage stage) {
+    static constexpr std::string_view NAMES[] = {
+        "parse"sv,
+        "posting_fetch"sv,
+        "scoring"sv,
+        "minus_filtering"sv,
+        "top_selection"sv,
+        "result_building"sv,
+        "find_top_documents"sv,
+        "process_queries"sv,
+        "add_document"sv,
+    };
+    static_assert(std::size(NAMES) == METRIC_STAGE_COUNT);
+    return NAMES[static_cast<size_t>(stage)];
+}
+
+std::string_view GetMetricName(MetricCounter counter) {
+    static constexpr std::string_view NAMES[] = {
+        "scored_postings"sv,
+        "minus_filtered_documents"sv,
+        "batch_queries"sv,
+        "indexed_words"sv,
+    };
+    static_assert(std::size(NAMES) == METRIC_COUNTER_COUNT);
+    return NAMES[static_cast<size_t>(counter)];
+}
+
+size_t LatencyHistogram::GetBucket(uint64_t value) {
+    static constexpr uint64_t UNIT_BUCKET_COUNT = uint64_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t HALF_COUNT = UNIT_BUCKET_COUNT / 2;
+    if (value < UNIT_BUCKET_COUNT) {
+        return value;
+    }
+    size_t top_bit = 0;
+    for (size_t step = 32; step > 0; step /= 2) {
+        if ((value >> (top_bit + step)) > 0) {
+            top_bit += step;
+        }
+    }
+    if (top_bit >= MAX_VALUE_BITS) {
+        return BUCKET_COUNT - 1;
+    }
+    // value >> shift is in [HALF_COUNT, UNIT_BUCKET_COUNT)
+    const size_t shift = top_bit - SUB_BUCKET_BITS + 1;
+    return UNIT_BUCKET_COUNT + (shift - 1) * HALF_COUNT + ((value >> shift) - HALF_COUNT);
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(size_t bucket) {
+    static constexpr uint64_t UNIT_BUCKET_COUNT = uint64_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t HALF_COUNT = UNIT_BUCKET_COUNT / 2;
+    if (bucket < UNIT_BUCKET_COUNT) {
+        return bucket;
+    }
+    const size_t shift = (bucket - UNIT_BUCKET_COUNT) / HALF_COUNT + 1;
+    const uint64_t sub_bucket = (bucket - UNIT_BUCKET_COUNT) % HALF_COUNT + HALF_COUNT;
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Add(const LatencyHistogram& other) {
+    count += other.count;
+    total += other.total;
+    max = std::max(max, other.max);
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        bucket_counts[i] += other.bucket_counts[i];
+    }
+}
+
+uint64_t LatencyHistogram::GetMean() const {
+    return count == 0 ? 0 : total / count;
+}
+
+uint64_t LatencyHistogram::GetPercentile(double quantile) const {
+    if (count == 0) {
+        return 0;
+    }
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * count)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += bucket_counts[i];
+        if (seen >= rank) {
+            return std::min(GetBucketUpperBound(i), max);
+        }
+    }
+    return max;
+}
+
+void MetricsSnapshot::PrintText(std::ostream& out) const {
+    for (size_t i = 0; i < METRIC_STAGE_COUNT; ++i) {
+        const auto& stage = stages[i];
+        if (stage.count == 0) {
+            continue;
+        }
+        out << GetMetricName(static_cast<MetricStage>(i)) << ": count "sv << stage.count
+            << ", mean "sv << stage.GetMean()
+            << " ns, p50 "sv << stage.GetPercentile(0.5)
+            << " ns, p99 "sv << stage.GetPercentile(0.99)
+            << " ns, p999 "sv << stage.GetPercentile(0.999)
+            << " ns, max "sv << stage.max << " ns\n"sv;
+    }
+    for (size_t i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+        out << GetMetricName(static_cast<MetricCounter>(i)) << ": "sv << counters[i] << '\n';
+    }
+}
+
+void MetricsSnapshot::PrintJson(std::ostream& out) const {
+    out << "{\"stages\":{"sv;
+    for (size_t i = 0; i < METRIC_STAGE_COUNT; ++i) {
+        const auto& stage = stages[i];
+        out << (i > 0 ? ","sv : ""sv) << '"' << GetMetricName(static_cast<MetricStage>(i))
+            << "\":{\"count\":"sv << stage.count
+            << ",\"mean_ns\":"sv << stage.GetMean()
+            << ",\"p50_ns\":"sv << stage.GetPercentile(0.5)
+            << ",\"p99_ns\":"sv << stage.GetPercentile(0.99)
+            << ",\"p999_ns\":"sv << stage.GetPercentile(0.999)
+            << ",\"max_ns\":"sv << stage.max << '}';
+    }
+    out << "},\"counters\":{"sv;
+    for (size_t i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+        out << (i > 0 ? ","sv : ""sv) << '"' << GetMetricName(static_cast<MetricCounter>(i))
+            << "\":"sv << counters[i];
+    }
+    out << "}}"sv;
+}
+
+MetricsSnapshot GetMetricsSnapshot() {
+    MetricsSnapshot snapshot;
+    MetricsRegistry::Get().ForEach(
+        [&snapshot](const ThreadMetrics& metrics) {
+            for (size_t i = 0; i < METRIC_STAGE_COUNT; ++i) {
+                const auto& counts = metrics.stages[i];
+                LatencyHistogram histogram;
+                histogram.count = counts.count.load(std::memory_order_relaxed);
+                histogram.total = counts.total.load(std::memory_order_relaxed);
+                histogram.max = counts.max.load(std::memory_order_relaxed);
+                for (size_t bucket = 0; bucket < LatencyHistogram::BUCKET_COUNT; ++bucket) {
+                    histogram.bucket_counts[bucket] = counts.bucket_counts[bucket].load(std::memory_order_relaxed);
+                }
+                snapshot.stages[i].Add(histogram);
+            }
+            for (size_t i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+                snapshot.counters[i] += metrics.counters[i].load(std::memory_order_relaxed);
+            }
+        }
+    );
+    return snapshot;
+}
+
+void ResetMetrics() {
+    MetricsRegistry::Get().ForEach(
+        [](ThreadMetrics& metrics) {
+            for (auto& counts : metrics.stages) {
+                counts.count.store(0, std::memory_order_relaxed);
+                counts.total.store(0, std::memory_order_relaxed);
+                counts.max.store(0, std::memory_order_relaxed);
+                for (auto& bucket_count : counts.bucket_counts) {
+                    bucket_count.store(0, std::memory_order_relaxed);
+                }
+            }
+            for (auto& counter : metrics.counters) {
+                counter.store(0, std::memory_order_relaxed);
+            }
+        }
+    );
+}
+
+void RecordLatency(MetricStage stage, uint64_t nanoseconds) {
+    auto& counts = GetThreadMetrics().stages[static_cast<size_t>(stage)];
+    Increase(counts.count, 1);
+    Increase(counts.total, nanoseconds);
+    if (nanoseconds > counts.max.load(std::memory_order_relaxed)) {
+        counts.max.store(nanoseconds, std::memory_order_relaxed);
+    }
+    Increase(counts.bucket_counts[LatencyHistogram::GetBucket(nanoseconds)], 1);
+}
+
+void AddToCounter(MetricCounter counter, uint64_t value) {
+    Increase(GetThreadMetrics().counters[static_cast<size_t>(counter)], value);
+}
\ No newline at end of file
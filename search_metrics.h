@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+// Latency histograms and counters of the search hot paths. Every thread records
+// into its own block, without locks, and a snapshot sums the blocks of all threads.
+// Defining SEARCH_SERVER_NO_METRICS removes the recording, snapshots are then empty
+
+enum class MetricStage {
+    // ParseQuery
+    PARSE,
+    // Looking up the words of a query and their posting lists
+    POSTING_FETCH,
+    // Walking the posting lists. The sequential search skips documents
+    // with minus words during this walk, so its minus filtering is here too
+    SCORING,
+    // Marking documents with minus words before the parallel search scores
+    MINUS_FILTERING,
+    // SelectTopDocuments
+    TOP_SELECTION,
+    // Copying the top into the returned documents
+    RESULT_BUILDING,
+    // Whole FindTopDocuments calls
+    FIND_TOP_DOCUMENTS,
+    // Whole ProcessQueries batches
+    PROCESS_QUERIES,
+    // Whole AddDocument calls
+    ADD_DOCUMENT,
+    STAGE_COUNT,
+};
+
+enum class MetricCounter {
+    // Postings whose score was computed
+    SCORED_POSTINGS,
+    // Documents skipped by the sequential search for a minus word
+    MINUS_FILTERED_DOCUMENTS,
+    // Queries of ProcessQueries batches
+    BATCH_QUERIES,
+    // Words of added documents, stop words excluded
+    INDEXED_WORDS,
+    COUNTER_COUNT,
+};
+
+constexpr size_t METRIC_STAGE_COUNT = static_cast<size_t>(MetricStage::STAGE_COUNT);
+constexpr size_t METRIC_COUNTER_COUNT = static_cast<size_t>(MetricCounter::COUNTER_COUNT);
+
+std::string_view GetMetricName(MetricStage stage);
+
+std::string_view GetMetricName(MetricCounter counter);
+
+// Durations in nanoseconds, in buckets that keep about 3% precision:
+// values below 64 have a bucket each, every next power of two is split into 32 buckets
+class LatencyHistogram {
+public:
+    static constexpr size_t SUB_BUCKET_BITS = 6;
+    // Longer durations, about 36 minutes, go into the last bucket
+    static constexpr size_t MAX_VALUE_BITS = 41;
+    static constexpr size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 2) << (SUB_BUCKET_BITS - 1);
+
+    static size_t GetBucket(uint64_t value);
+
+    // The largest value that falls into bucket
+    static uint64_t GetBucketUpperBound(size_t bucket);
+
+    void Add(const LatencyHistogram& other);
+
+    uint64_t GetMean() const;
+
+    // The value that quantile (from 0 to 1) of the recorded values do not exceed,
+    // up to the precision of the buckets
+    uint64_t GetPercentile(double quantile) const;
+
+    uint64_t count = 0;
+    uint64_t total = 0;
+    uint64_t max = 0;
+    std::array<uint64_t, BUCKET_COUNT> bucket_counts{};
+};
+
+struct MetricsSnapshot {
+    std::array<LatencyHistogram, METRIC_STAGE_COUNT> stages;
+    std::array<uint64_t, METRIC_COUNTER_COUNT> counters{};
+
+    const LatencyHistogram& GetStage(MetricStage stage) const {
+        return stages[static_cast<size_t>(stage)];
+    }
+
+    uint64_t GetCounter(MetricCounter counter) const {
+        return counters[static_cast<size_t>(counter)];
+    }
+
+    // Count, mean, p50, p99, p999 and max of every recorded stage, and the counters
+    void PrintText(std::ostream& out) const;
+
+    void PrintJson(std::ostream& out) const;
+};
+
+// Sums what all threads have recorded, including threads that have exited
+MetricsSnapshot GetMetricsSnapshot();
+
+// Must not run while metrics are recorded, or some of them may survive
+void ResetMetrics();
+
+void RecordLatency(MetricStage stage, uint64_t nanoseconds);
+
+void AddToCounter(MetricCounter counter, uint64_t value);
+
+// Records the time from its construction to its destruction
+class MetricsTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit MetricsTimer(MetricStage stage)
+        : stage_(stage) {
+    }
+
+    MetricsTimer(const MetricsTimer&) = delete;
+    MetricsTimer& operator=(const MetricsTimer&) = delete;
+
+    ~MetricsTimer() {
+        RecordLatency(stage_, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - start_time_).count());
+    }
+
+private:
+    const MetricStage stage_;
+    const Clock::time_point start_time_ = Clock::now();
+};
+
+#define METRICS_CONCAT_INTERNAL(X, Y) X##Y
+#define METRICS_CONCAT(X, Y) METRICS_CONCAT_INTERNAL(X, Y)
+
+#ifdef SEARCH_SERVER_NO_METRICS
+#define METRICS_STAGE(stage)
+#define METRICS_COUNT(counter, value)
+#else
+// Times the rest of the enclosing scope as MetricStage::stage
+#define METRICS_STAGE(stage) MetricsTimer METRICS_CONCAT(metrics_timer, __LINE__)(MetricStage::stage)
+#define METRICS_COUNT(counter, value) AddToCounter(MetricCounter::counter, value)
+#endif
\ No newline at end of file
@@ -0,0 +1,315 @@
+#include "segmented_search_server.h"
+#include "string_processing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+using std::string;
+using std::vector;
+
+SegmentedSearchServer::SegmentedSearchServer(const string& stop_words_text, SegmentMergePolicy merge_policy,
+                                             std::shared_ptr<ThreadPool> thread_pool)
+    : stop_words_text_(stop_words_text)
+    , merge_policy_(merge_policy)
+    , thread_pool_(std::move(thread_pool))
+{
+    if (merge_policy_.max_mutable_document_count == 0 || merge_policy_.merge_factor < 2) {
+        throw std::invalid_argument("Invalid merge policy"s);
+    }
+    mutable_segment_ = MakeSegment();
+    merger_ = std::thread([this] {
+        MergeLoop();
+    });
+}
+
+SegmentedSearchServer::~SegmentedSearchServer() {
+    {
+        std::lock_guard guard(merge_mutex_);
+        stopping_ = true;
+    }
+    merge_wake_.notify_all();
+    merger_.join();
+}
+
+DocumentTable::ConstIterator SegmentedSearchServer::begin() const {
+    return DocumentTable::ConstIterator(document_segments_.begin());
+}
+
+DocumentTable::ConstIterator SegmentedSearchServer::end() const {
+    return DocumentTable::ConstIterator(document_segments_.end());
+}
+
+void SegmentedSearchServer::AddDocument(int document_id, std::string_view document,
+                                        DocumentStatus status, const vector<int>& ratings) {
+    bool sealed = false;
+    {
+        std::unique_lock lock(mutex_);
+        if (document_segments_.count(document_id) > 0) {
+            throw std::invalid_argument("Invalid document_id"s);
+        }
+        mutable_segment_->server.AddDocument(document_id, document, status, ratings);
+        document_segments_.emplace(document_id, mutable_segment_->id);
+        if (static_cast<size_t>(mutable_segment_->server.GetDocumentCount()) >= merge_policy_.max_mutable_document_count) {
+            sealed_segments_.push_back(std::move(mutable_segment_));
+            mutable_segment_ = MakeSegment();
+            sealed = true;
+        }
+    }
+    if (sealed) {
+        RequestMerge();
+    }
+}
+
+void SegmentedSearchServer::RemoveDocument(int document_id) {
+    bool merge_needed = false;
+    {
+        std::unique_lock lock(mutex_);
+        const auto it = document_segments_.find(document_id);
+        if (it == document_segments_.end()) {
+            return;
+        }
+        if (it->second == mutable_segment_->id) {
+            mutable_segment_->server.RemoveDocument(std::execution::seq, document_id);
+        }
+        else {
+            auto& segment = **std::find_if(sealed_segments_.begin(), sealed_segments_.end(),
+                [segment_id = it->second](const auto& segment) {
+                    return segment->id == segment_id;
+                }
+            );
+            segment.deleted.Insert(document_id);
+            merge_needed = segment.deleted.size()
+                >= merge_policy_.max_deleted_share * segment.server.GetDocumentCount();
+        }
+        document_segments_.erase(it);
+    }
+    if (merge_needed) {
+        RequestMerge();
+    }
+}
+
+vector<Document> SegmentedSearchServer::FindTopDocuments(const std::execution::sequenced_policy&, std::string_view raw_query,
+                                                         DocumentStatus status, size_t max_result_count) const {
+    return FindTopDocuments(std::execution::seq, raw_query,
+        [status](int, DocumentStatus document_status, int) {
+            return document_status == status;
+        },
+        max_result_count);
+}
+
+vector<Document> SegmentedSearchServer::FindTopDocuments(const std::execution::parallel_policy&, std::string_view raw_query,
+                                                         DocumentStatus status, size_t max_result_count) const {
+    return FindTopDocuments(std::execution::par, raw_query,
+        [status](int, DocumentStatus document_status, int) {
+            return document_status == status;
+        },
+        max_result_count);
+}
+
+vector<Document> SegmentedSearchServer::FindTopDocuments(std::string_view raw_query, DocumentStatus status,
+                                                         size_t max_result_count) const {
+    return FindTopDocuments(std::execution::seq, raw_query, status, max_result_count);
+}
+
+vector<Document> SegmentedSearchServer::FindTopDocuments(std::string_view raw_query) const {
+    return FindTopDocuments(raw_query, DocumentStatus::ACTUAL);
+}
+
+int SegmentedSearchServer::GetDocumentCount() const {
+    std::shared_lock lock(mutex_);
+    return static_cast<int>(document_segments_.size());
+}
+
+size_t SegmentedSearchServer::GetSegmentCount() const {
+    std::shared_lock lock(mutex_);
+    return sealed_segments_.size() + 1;
+}
+
+std::tuple<vector<std::string_view>, DocumentStatus> SegmentedSearchServer::MatchDocument(
+    std::string_view raw_query, int document_id) const {
+    std::shared_lock lock(mutex_);
+    const auto it = document_segments_.find(document_id);
+    if (it == document_segments_.end()) {
+        throw std::out_of_range("No document with id "s + std::to_string(document_id));
+    }
+    for (const Segment* segment : GetSegments()) {
+        if (segment->id == it->second) {
+            // Matched words are views of raw_query, so they outlive a merge of the segment
+            return segment->server.MatchDocument(raw_query, document_id);
+        }
+    }
+    throw std::logic_error("Document segment is missing"s);
+}
+
+void SegmentedSearchServer::WaitForMerges() {
+    RequestMerge();
+    std::unique_lock lock(merge_mutex_);
+    merge_done_.wait(lock, [this] {
+        return !merge_requested_ && !merging_;
+    });
+}
+
+std::shared_ptr<SegmentedSearchServer::Segment> SegmentedSearchServer::MakeSegment() {
+    return std::make_shared<Segment>(Segment{ next_segment_id_++, SearchServer(stop_words_text_, thread_pool_), {} });
+}
+
+vector<const SegmentedSearchServer::Segment*> SegmentedSearchServer::GetSegments() const {
+    vector<const Segment*> segments;
+    segments.reserve(sealed_segments_.size() + 1);
+    for (const auto& segment : sealed_segments_) {
+        segments.push_back(segment.get());
+    }
+    segments.push_back(mutable_segment_.get());
+    return segments;
+}
+
+SearchServer::InverseDocumentFreq SegmentedSearchServer::ComputeInverseDocumentFreqs(std::string_view raw_query,
+    const vector<const Segment*>& segments) const {
+    size_t document_count = 0;
+    for (const Segment* segment : segments) {
+        document_count += segment->server.GetDocumentCount();
+    }
+    // Computed the way SearchServer computes them, so one segment ranks as one server
+    std::unordered_map<std::string_view, double> inverse_document_freqs;
+    for (const std::string_view word : SplitIntoWords(raw_query)) {
+        if (word.empty() || word[0] == '-' || inverse_document_freqs.count(word) > 0) {
+            continue;
+        }
+        size_t document_freq = 0;
+        for (const Segment* segment : segments) {
+            document_freq += segment->server.GetDocumentFreq(word);
+        }
+        inverse_document_freqs[word] = document_freq == 0
+            ? 0.0
+            : log(document_count) - log(document_freq);
+    }
+    return [inverse_document_freqs = std::move(inverse_document_freqs)](std::string_view word) {
+        const auto it = inverse_document_freqs.find(word);
+        return it == inverse_document_freqs.end() ? 0.0 : it->second;
+    };
+}
+
+vector<std::shared_ptr<SegmentedSearchServer::Segment>> SegmentedSearchServer::SelectMerge() const {
+    for (const auto& segment : sealed_segments_) {
+        if (!segment->deleted.empty() && segment->deleted.size()
+            >= merge_policy_.max_deleted_share * segment->server.GetDocumentCount()) {
+            return { segment };
+        }
+    }
+
+    // Tier 0 holds segments below max_mutable_document_count * merge_factor live documents
+    const auto get_tier = [this](const Segment& segment) {
+        size_t tier = 0;
+        size_t tier_limit = merge_policy_.max_mutable_document_count * merge_policy_.merge_factor;
+        const size_t document_count = segment.server.GetDocumentCount() - segment.deleted.size();
+        while (document_count >= tier_limit) {
+            ++tier;
+            tier_limit *= merge_policy_.merge_factor;
+        }
+        return tier;
+    };
+    std::map<size_t, vector<std::shared_ptr<Segment>>> tiers;
+    for (const auto& segment : sealed_segments_) {
+        tiers[get_tier(*segment)].push_back(segment);
+    }
+    for (auto& [_, segments] : tiers) {
+        if (segments.size() >= merge_policy_.merge_factor) {
+            segments.resize(merge_policy_.merge_factor);
+            return segments;
+        }
+    }
+    return {};
+}
+
+bool SegmentedSearchServer::MergeOnce() {
+    vector<std::shared_ptr<Segment>> inputs;
+    vector<DocumentIdSet> live_documents;
+    {
+        // Sealed segments are not changed, but their delete sets are
+        std::shared_lock lock(mutex_);
+        inputs = SelectMerge();
+        if (inputs.empty()) {
+            return false;
+        }
+        for (const auto& input : inputs) {
+            DocumentIdSet documents;
+            for (const int document_id : input->server) {
+                if (!input->deleted.Contains(document_id)) {
+                    documents.Insert(document_id);
+                }
+            }
+            live_documents.push_back(std::move(documents));
+        }
+    }
+
+    const auto merged = MakeSegment();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        merged->server.AddDocumentsFrom(inputs[i]->server,
+            [&documents = live_documents[i]](int document_id, DocumentStatus, int) {
+                return documents.Contains(document_id);
+            }
+        );
+    }
+
+    std::unique_lock lock(mutex_);
+    // Documents removed during the merge are deleted in the merged segment
+    const auto is_input = [&inputs](uint32_t segment_id) {
+        return std::any_of(inputs.begin(), inputs.end(),
+            [segment_id](const auto& input) {
+                return input->id == segment_id;
+            }
+        );
+    };
+    for (const int document_id : merged->server) {
+        const auto it = document_segments_.find(document_id);
+        if (it != document_segments_.end() && is_input(it->second)) {
+            it->second = merged->id;
+        }
+        else {
+            merged->deleted.Insert(document_id);
+        }
+    }
+    sealed_segments_.erase(std::remove_if(sealed_segments_.begin(), sealed_segments_.end(),
+        [&is_input](const auto& segment) {
+            return is_input(segment->id);
+        }
+    ), sealed_segments_.end());
+    if (merged->deleted.size() < static_cast<size_t>(merged->server.GetDocumentCount())) {
+        sealed_segments_.push_back(merged);
+    }
+    return true;
+}
+
+void SegmentedSearchServer::RequestMerge() {
+    {
+        std::lock_guard guard(merge_mutex_);
+        merge_requested_ = true;
+    }
+    merge_wake_.notify_one();
+}
+
+void SegmentedSearchServer::MergeLoop() {
+    while (true) {
+        {
+            std::unique_lock lock(merge_mutex_);
+            merge_wake_.wait(lock, [this] {
+                return stopping_ || merge_requested_;
+            });
+            if (stopping_) {
+                return;
+            }
+            merge_requested_ = false;
+            merging_ = true;
+        }
+        while (!stopping_ && MergeOnce()) {
+        }
+        {
+            std::lock_guard guard(merge_mutex_);
+            merging_ = false;
+        }
+        merge_done_.notify_all();
+    }
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <execution>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "document.h"
+#include "document_id_set.h"
+#include "document_table.h"
+#include "search_server.h"
+#include "thread_pool.h"
+#include "top_documents.h"
+
+// When SegmentedSearchServer seals and merges its segments
+struct SegmentMergePolicy {
+    // Documents the mutable segment takes before it is sealed
+    size_t max_mutable_document_count = 4096;
+    // Segments of a tier are up to merge_factor times larger than those of the tier below,
+    // and merge_factor segments of one tier are merged into one
+    size_t merge_factor = 8;
+    // A segment with this share of deleted documents is rewritten without them
+    double max_deleted_share = 0.3;
+};
+
+// Index split into segments, LSM-style. New documents go to a small mutable segment,
+// which is sealed when it is full. A sealed segment is never changed: a removed document
+// is only marked in its delete set. A background thread merges sealed segments by
+// SegmentMergePolicy, dropping deleted documents, so adding and removing a document
+// take the same time however large the index is.
+// Queries search every segment with inverse document freqs of the whole index and
+// merge the tops. As in a merged index, deleted documents still count in these freqs
+// until their segment is merged.
+// Queries may run alongside each other and alongside the merges; AddDocument and
+// RemoveDocument wait for the queries that have started
+class SegmentedSearchServer {
+public:
+    explicit SegmentedSearchServer(const std::string& stop_words_text,
+        SegmentMergePolicy merge_policy = {},
+        std::shared_ptr<ThreadPool> thread_pool = ThreadPool::GetDefault());
+
+    SegmentedSearchServer(const SegmentedSearchServer&) = delete;
+    SegmentedSearchServer& operator=(const SegmentedSearchServer&) = delete;
+
+    ~SegmentedSearchServer();
+
+    // Must not be used while documents are added or removed
+    DocumentTable::ConstIterator begin() const;
+
+    DocumentTable::ConstIterator end() const;
+
+    void AddDocument(int document_id, std::string_view document,
+        DocumentStatus status, const std::vector<int>& ratings);
+
+    void RemoveDocument(int document_id);
+
+    template <typename DocumentPredicate>
+    std::vector<Document> FindTopDocuments(const std::execution::sequenced_policy&,
+        std::string_view raw_query, DocumentPredicate document_predicate,
+        size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    // Searches the segments in parallel
+    template <typename DocumentPredicate>
+    std::vector<Document> FindTopDocuments(const std::execution::parallel_policy&,
+        std::string_view raw_query, DocumentPredicate document_predicate,
+        size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    template <typename DocumentPredicate>
+    std::vector<Document> FindTopDocuments(std::string_view raw_query,
+        DocumentPredicate document_predicate, size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    std::vector<Document> FindTopDocuments(const std::execution::sequenced_policy&, std::string_view raw_query,
+        DocumentStatus status, size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    std::vector<Document> FindTopDocuments(const std::execution::parallel_policy&, std::string_view raw_query,
+        DocumentStatus status, size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    std::vector<Document> FindTopDocuments(std::string_view raw_query,
+        DocumentStatus status, size_t max_result_count = MAX_RESULT_DOCUMENT_COUNT) const;
+
+    std::vector<Document> FindTopDocuments(std::string_view raw_query) const;
+
+    int GetDocumentCount() const;
+
+    // Sealed segments and the mutable one
+    size_t GetSegmentCount() const;
+
+    std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(
+        std::string_view raw_query, int document_id) const;
+
+    // Returns when the merger has nothing left to merge
+    void WaitForMerges();
+
+private:
+    struct Segment {
+        uint32_t id;
+        SearchServer server;
+        // Documents removed from a sealed segment, which stay in server until it is merged
+        DocumentIdSet deleted;
+    };
+
+    std::shared_ptr<Segment> MakeSegment();
+
+    std::vector<const Segment*> GetSegments() const;
+
+    SearchServer::InverseDocumentFreq ComputeInverseDocumentFreqs(std::string_view raw_query,
+        const std::vector<const Segment*>& segments) const;
+
+    template <typename DocumentPredicate>
+    static std::vector<Document> FindSegmentDocuments(const Segment& segment, std::string_view raw_query,
+        DocumentPredicate document_predicate, const SearchServer::InverseDocumentFreq& inverse_document_freq,
+        size_t max_result_count);
+
+    // Sealed segments that should be merged next, empty if there are none
+    std::vector<std::shared_ptr<Segment>> SelectMerge() const;
+
+    // Returns false if there was nothing to merge
+    bool MergeOnce();
+
+    void RequestMerge();
+
+    void MergeLoop();
+
+    const std::string stop_words_text_;
+    const SegmentMergePolicy merge_policy_;
+    std::shared_ptr<ThreadPool> thread_pool_;
+
+    // Guards the segments, their delete sets and document_segments_
+    mutable std::shared_mutex mutex_;
+    std::shared_ptr<Segment> mutable_segment_;
+    std::vector<std::shared_ptr<Segment>> sealed_segments_;
+    // Segment id of every document that is not removed
+    std::map<int, uint32_t> document_segments_;
+    std::atomic<uint32_t> next_segment_id_ = 0;
+
+    std::mutex merge_mutex_;
+    std::condition_variable merge_wake_;
+    std::condition_variable merge_done_;
+    bool merge_requested_ = false;
+    bool merging_ = false;
+    std::atomic<bool> stopping_ = false;
+    std::thread merger_;
+};
+
+template <typename DocumentPredicate>
+std::vector<Document> SegmentedSearchServer::FindSegmentDocuments(const Segment& segment, std::string_view raw_query,
+        DocumentPredicate document_predicate, const SearchServer::InverseDocumentFreq& inverse_document_freq,
+        size_t max_result_count) {
+    if (segment.deleted.empty()) {
+        return segment.server.FindTopDocuments(std::execution::seq, raw_query, document_predicate,
+            inverse_document_freq, max_result_count);
+    }
+    return segment.server.FindTopDocuments(std::execution::seq, raw_query,
+        [&segment, &document_predicate](int document_id, DocumentStatus status, int rating) {
+            return !segment.deleted.Contains(document_id) && document_predicate(document_id, status, rating);
+        },
+        inverse_document_freq, max_result_count);
+}
+
+template <typename DocumentPredicate>
+std::vector<Document> SegmentedSearchServer::FindTopDocuments(const std::execution::sequenced_policy&,
+        std::string_view raw_query, DocumentPredicate document_predicate, size_t max_result_count) const {
+    std::shared_lock lock(mutex_);
+    const auto segments = GetSegments();
+    const auto inverse_document_freq = ComputeInverseDocumentFreqs(raw_query, segments);
+    std::vector<Document> documents;
+    for (const Segment* segment : segments) {
+        const auto segment_documents = FindSegmentDocuments(*segment, raw_query, document_predicate,
+            inverse_document_freq, max_result_count);
+        documents.insert(documents.end(), segment_documents.begin(), segment_documents.end());
+    }
+    SelectTopDocuments(std::execution::seq, documents, max_result_count);
+    return documents;
+}
+
+template <typename DocumentPredicate>
+std::vector<Document> SegmentedSearchServer::FindTopDocuments(const std::execution::parallel_policy&,
+        std::string_view raw_query, DocumentPredicate document_predicate, size_t max_result_count) const {
+    std::shared_lock lock(mutex_);
+    const auto segments = GetSegments();
+    const auto inverse_document_freq = ComputeInverseDocumentFreqs(raw_query, segments);
+    std::vector<std::vector<Document>> segment_documents(segments.size());
+    thread_pool_->ParallelFor(segments.size(),
+        [&](size_t i) {
+            segment_documents[i] = FindSegmentDocuments(*segments[i], raw_query, document_predicate,
+                inverse_document_freq, max_result_count);
+        }
+    );
+    std::vector<Document> documents;
+    for (const auto& top : segment_documents) {
+        documents.insert(documents.end(), top.begin(), top.end());
+    }
+    SelectTopDocuments(std::execution::seq, documents, max_result_count);
+    return documents;
+}
+
+template <typename DocumentPredicate>
+std::vector<Document> SegmentedSearchServer::FindTopDocuments(std::string_view raw_query,
+        DocumentPredicate document_predicate, size_t max_result_count) const {
+    return FindTopDocuments(std::execution::seq, raw_query, document_predicate, max_result_count);
+}
@@ -1,10 +1,23 @@
 #include "string_processing.h"
 
+#include <cstdint>
 #include <execution>
 #include <functional>
 #include <iterator>
 #include <numeric>
 
+// SSE2 is part of x86-64, AVX2 is used only if the CPU reports it
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_TOKENIZER
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
 using std::string;
 using std::string_view;
 using std::vector;
@@ -52,22 +65,145 @@ using std::vector;
 
 std::vector<std::string_view> SplitIntoWords(std::string_view str) {
     std::vector<std::string_view> result;
-    //std::vector<std::string_view> result(CountWords(str));
-    //std::vector<std::string_view> result(std::count(str.begin(), str.end(), ' '));
-    const int64_t pos_end = str.npos;
-    while (true) {
-        int64_t space = str.find(' ');
-        result.push_back(space == pos_end ? str : str.substr(0, space));
-        //result.push_back(str.substr(0, space));
-        if (space == pos_end) {
-            break;
+    SplitIntoValidWords(str, result);
+    return result;
+}
+
+namespace {
+
+unsigned CountTrailingZeros(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// State of one SplitIntoValidWords call, fed with bit masks of spaces and
+// control characters found in blocks of the text
+class WordSplitter {
+public:
+    WordSplitter(string_view str, vector<string_view>& words)
+        : str_(str)
+        , words_(words) {
+        words_.clear();
+    }
+
+    // Bit i of the masks stands for the character at offset + i
+    void AddBlock(size_t offset, uint32_t space_mask, uint32_t invalid_mask) {
+        for (; space_mask != 0; space_mask &= space_mask - 1) {
+            AddSpace(offset + CountTrailingZeros(space_mask));
         }
-        else {
-            str.remove_prefix(space + 1);
+        if (invalid_mask != 0 && first_invalid_ == string_view::npos) {
+            first_invalid_ = offset + CountTrailingZeros(invalid_mask);
         }
     }
 
-    return result;
+    // Checks the characters from offset on one by one
+    size_t Finish(size_t offset) {
+        for (; offset < str_.size(); ++offset) {
+            const unsigned char c = str_[offset];
+            if (c == ' ') {
+                AddSpace(offset);
+            }
+            else if (c < ' ' && first_invalid_ == string_view::npos) {
+                first_invalid_ = offset;
+            }
+        }
+        words_.push_back(str_.substr(word_begin_));
+        return first_invalid_;
+    }
+
+private:
+    void AddSpace(size_t position) {
+        words_.push_back(str_.substr(word_begin_, position - word_begin_));
+        word_begin_ = position + 1;
+    }
+
+    string_view str_;
+    vector<string_view>& words_;
+    size_t word_begin_ = 0;
+    size_t first_invalid_ = string_view::npos;
+};
+
+#ifdef SIMD_TOKENIZER
+
+size_t SplitSse2(string_view str, vector<string_view>& words) {
+    WordSplitter splitter(str, words);
+    const __m128i spaces = _mm_set1_epi8(' ');
+    const __m128i max_invalid = _mm_set1_epi8(' ' - 1);
+    size_t offset = 0;
+    for (; offset + sizeof(__m128i) <= str.size(); offset += sizeof(__m128i)) {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str.data() + offset));
+        const __m128i is_space = _mm_cmpeq_epi8(chars, spaces);
+        // Unsigned c <= max_invalid exactly when min(c, max_invalid) == c
+        const __m128i is_invalid = _mm_cmpeq_epi8(_mm_min_epu8(chars, max_invalid), chars);
+        splitter.AddBlock(offset, static_cast<uint32_t>(_mm_movemask_epi8(is_space)),
+            static_cast<uint32_t>(_mm_movemask_epi8(is_invalid)));
+    }
+    return splitter.Finish(offset);
+}
+
+TARGET_AVX2 size_t SplitAvx2(string_view str, vector<string_view>& words) {
+    WordSplitter splitter(str, words);
+    const __m256i spaces = _mm256_set1_epi8(' ');
+    const __m256i max_invalid = _mm256_set1_epi8(' ' - 1);
+    size_t offset = 0;
+    for (; offset + sizeof(__m256i) <= str.size(); offset += sizeof(__m256i)) {
+        const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str.data() + offset));
+        const __m256i is_space = _mm256_cmpeq_epi8(chars, spaces);
+        const __m256i is_invalid = _mm256_cmpeq_epi8(_mm256_min_epu8(chars, max_invalid), chars);
+        splitter.AddBlock(offset, static_cast<uint32_t>(_mm256_movemask_epi8(is_space)),
+            static_cast<uint32_t>(_mm256_movemask_epi8(is_invalid)));
+    }
+    return splitter.Finish(offset);
+}
+
+bool HasAvx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    // The OS must also save the AVX registers on context switches
+    __cpuid(info, 1);
+    const int osxsave_and_avx = (1 << 27) | (1 << 28);
+    if ((info[2] & osxsave_and_avx) != osxsave_and_avx || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#else
+
+size_t SplitScalar(string_view str, vector<string_view>& words) {
+    return WordSplitter(str, words).Finish(0);
+}
+
+#endif
+
+using SplitFunction = size_t (*)(string_view, vector<string_view>&);
+
+SplitFunction SelectSplitFunction() {
+#ifdef SIMD_TOKENIZER
+    return HasAvx2() ? SplitAvx2 : SplitSse2;
+#else
+    return SplitScalar;
+#endif
+}
+
+} // namespace
+
+size_t SplitIntoValidWords(string_view str, vector<string_view>& words) {
+    static const SplitFunction split = SelectSplitFunction();
+    return split(str, words);
 }
 
 ////        string_view
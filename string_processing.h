@@ -10,6 +10,12 @@
 //std::vector<std::string> SplitIntoWords(const std::string& text);
 std::vector<std::string_view> SplitIntoWords(std::string_view str);
 
+// Splits str at every space into words (consecutive spaces give empty words),
+// replacing the contents of words, and looks for control characters
+// (bytes below ' ') in the same pass. Uses AVX2 or SSE2 when the CPU has them.
+// Returns the position of the first control character or std::string_view::npos
+size_t SplitIntoValidWords(std::string_view str, std::vector<std::string_view>& words);
+
 //template <typename StringContainer>
 //std::set<std::string> MakeUniqueNonEmptyStrings(const StringContainer& strings) {
 //    std::set<std::string> non_empty_strings;
@@ -25,7 +31,7 @@ template <typename StringContainer>
 std::set<std::string, std::less<>> MakeUniqueNonEmptyStrings(const StringContainer& strings) {
     //std::vector<std::string> non_empty_strings(strings.begin(), strings.end());
     std::set<std::string, std::less<>> non_empty_strings;
-    for (const std::string_view& str : strings) {
+    for (const std::string_view str : strings) {
         if (!str.empty()) {
             non_empty_strings.insert(std::string(str));
         }
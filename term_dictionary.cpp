@@ -0,0 +1,60 @@
+#include "term_dictionary.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using std::string_view;
+
+TermId TermDictionary::Intern(string_view word) {
+    const auto term_it = term_ids_.find(word);
+    if (term_it != term_ids_.end()) {
+        return term_it->second;
+    }
+    return Add(Store(word));
+}
+
+TermId TermDictionary::InternStored(string_view word) {
+    const auto term_it = term_ids_.find(word);
+    if (term_it != term_ids_.end()) {
+        return term_it->second;
+    }
+    return Add(word);
+}
+
+TermId TermDictionary::Find(string_view word) const {
+    const auto term_it = term_ids_.find(word);
+    return term_it == term_ids_.end() ? NO_TERM : term_it->second;
+}
+
+string_view TermDictionary::GetWord(TermId term_id) const {
+    return words_.at(term_id);
+}
+
+size_t TermDictionary::size() const {
+    return words_.size();
+}
+
+TermId TermDictionary::Add(string_view stored_word) {
+    if (words_.size() == NO_TERM) {
+        throw std::length_error("Too many distinct words");
+    }
+    const TermId term_id = static_cast<TermId>(words_.size());
+    words_.push_back(stored_word);
+    term_ids_.emplace(stored_word, term_id);
+    return term_id;
+}
+
+string_view TermDictionary::Store(string_view word) {
+    if (word.size() > chunk_free_) {
+        // A word longer than a chunk gets a chunk of its own
+        const size_t chunk_size = std::max(CHUNK_SIZE, word.size());
+        chunks_.push_back(std::make_unique<char[]>(chunk_size));
+        chunk_pos_ = chunks_.back().get();
+        chunk_free_ = chunk_size;
+    }
+    const string_view stored_word(chunk_pos_, word.size());
+    std::copy(word.begin(), word.end(), chunk_pos_);
+    chunk_pos_ += word.size();
+    chunk_free_ -= word.size();
+    return stored_word;
+}
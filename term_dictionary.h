@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using TermId = uint32_t;
+
+// Interns words: every distinct word is stored once in chunked storage
+// that never moves, so the returned string_views stay valid for the
+// lifetime of the dictionary.
+class TermDictionary {
+public:
+    static constexpr TermId NO_TERM = std::numeric_limits<TermId>::max();
+
+    // Returns the id of word, storing the word if it is new
+    TermId Intern(std::string_view word);
+
+    // Same as Intern, but keeps a view of word instead of a copy,
+    // so the text of word must outlive the dictionary
+    TermId InternStored(std::string_view word);
+
+    // Returns NO_TERM if the word was never interned
+    TermId Find(std::string_view word) const;
+
+    std::string_view GetWord(TermId term_id) const;
+
+    size_t size() const;
+
+private:
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    TermId Add(std::string_view stored_word);
+
+    std::string_view Store(std::string_view word);
+
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    char* chunk_pos_ = nullptr;
+    size_t chunk_free_ = 0;
+    std::vector<std::string_view> words_;
+    std::unordered_map<std::string_view, TermId> term_ids_;
+};
@@ -0,0 +1,52 @@
+#include "search_server.h"
+
+#include "check.h"
+
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+bool AcceptAll(int, DocumentStatus, int) {
+    return true;
+}
+
+void TestAddDocumentsFrom() {
+    SearchServer source("and"s);
+    source.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    source.AddDocument(2, "curly cat curly tail"s, DocumentStatus::BANNED, { 2 });
+    SearchServer search_server("and"s);
+    search_server.AddDocument(3, "nasty dog"s, DocumentStatus::ACTUAL, { 3 });
+
+    search_server.AddDocumentsFrom(source, AcceptAll);
+    CHECK(search_server.GetDocumentCount() == 3);
+    CHECK(search_server.FindTopDocuments("cat"s).size() == 1);
+    CHECK(search_server.FindTopDocuments("cat"s, DocumentStatus::BANNED).size() == 1);
+}
+
+// A document this server has already makes the call add nothing at all
+void TestAddDocumentsFromWithClash() {
+    SearchServer source("and"s);
+    source.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    source.AddDocument(2, "curly cat curly tail"s, DocumentStatus::ACTUAL, { 2 });
+    SearchServer search_server("and"s);
+    search_server.AddDocument(2, "nasty dog"s, DocumentStatus::ACTUAL, { 3 });
+
+    bool thrown = false;
+    try {
+        search_server.AddDocumentsFrom(source, AcceptAll);
+    }
+    catch (const invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(search_server.GetDocumentCount() == 1);
+    CHECK(search_server.FindTopDocuments("cat"s).empty());
+    CHECK(search_server.GetDocumentFreq("cat"sv) == 0);
+}
+
+int main() {
+    TestAddDocumentsFrom();
+    TestAddDocumentsFromWithClash();
+    return 0;
+}
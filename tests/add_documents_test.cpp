@@ -0,0 +1,129 @@
+#include "search_server.h"
+#include "generators.h"
+
+#include "check.h"
+
+#include <cmath>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+const vector<string> QUERIES = { "a"s, "b c"s, "d -e"s, "f g h -a"s, "cat"s };
+
+// Term ids depend on the order words were first seen, so the terms are compared by word
+map<string_view, double> GetWordFrequencies(const SearchServer& search_server, int document_id) {
+    map<string_view, double> word_freqs;
+    for (const auto& [term_id, term_freq] : search_server.GetWordFrequencies(document_id)) {
+        word_freqs[search_server.GetWord(term_id)] = term_freq;
+    }
+    return word_freqs;
+}
+
+void CheckSameIndex(const SearchServer& search_server, const SearchServer& expected_server) {
+    CHECK(search_server.GetDocumentCount() == expected_server.GetDocumentCount());
+    for (const string& query : QUERIES) {
+        const auto documents = search_server.FindTopDocuments(query);
+        const auto expected_documents = expected_server.FindTopDocuments(query);
+        CHECK(documents.size() == expected_documents.size());
+        for (size_t i = 0; i < documents.size(); ++i) {
+            CHECK(documents[i].id == expected_documents[i].id);
+            CHECK(documents[i].rating == expected_documents[i].rating);
+            CHECK(abs(documents[i].relevance - expected_documents[i].relevance) < 1e-9);
+        }
+    }
+    auto it = search_server.begin();
+    for (const int document_id : expected_server) {
+        CHECK(it != search_server.end() && *it == document_id);
+        ++it;
+        CHECK(GetWordFrequencies(search_server, document_id) == GetWordFrequencies(expected_server, document_id));
+        for (const string& query : QUERIES) {
+            CHECK(search_server.MatchDocument(query, document_id) == expected_server.MatchDocument(query, document_id));
+        }
+    }
+}
+
+// Documents with an id that is negative, already in the server or repeated in the batch,
+// or with a word of control characters, are reported by their position and skipped.
+// The rest of the batch is indexed as AddDocument would index it
+void TestErrorsInBatch(PostingFormat posting_format) {
+    mt19937 generator;
+    const auto dictionary = GenerateIndexedDictionary(50);
+    const ZipfDistribution zipf(dictionary.size());
+    const auto texts = GenerateZipfTexts(generator, dictionary, zipf, 300, 1, 20);
+
+    SearchServer search_server("z"s, ThreadPool::GetDefault(), posting_format);
+    SearchServer expected_server("z"s);
+    for (SearchServer* server : { &search_server, &expected_server }) {
+        server->AddDocument(1'000, "cat and dog"s, DocumentStatus::ACTUAL, { 1 });
+    }
+
+    // Bad documents are spread over the batch, so they fall into different blocks of it
+    vector<string> batch_texts;
+    vector<DocumentInput> documents;
+    vector<DocumentError> expected_errors;
+    for (int i = 0; i < 300; ++i) {
+        batch_texts.push_back(texts[i]);
+        DocumentInput document{ i, {}, i % 3 == 0 ? DocumentStatus::ACTUAL : DocumentStatus::IRRELEVANT, { i % 5, -i } };
+        if (i % 11 == 1) {
+            document.id = 1'000;
+        }
+        else if (i % 11 == 4) {
+            document.id = i - 1;
+        }
+        else if (i % 11 == 7) {
+            document.id = -i;
+        }
+        else if (i % 11 == 9) {
+            batch_texts.back() += " ca\x01t"s;
+        }
+        if (i % 11 == 1 || i % 11 == 4 || i % 11 == 7 || i % 11 == 9) {
+            expected_errors.push_back({ static_cast<size_t>(i), document.id, {} });
+        }
+        else {
+            expected_server.AddDocument(document.id, batch_texts.back(), document.status, document.ratings);
+        }
+        documents.push_back(document);
+    }
+    for (size_t i = 0; i < documents.size(); ++i) {
+        documents[i].text = batch_texts[i];
+    }
+
+    const auto errors = search_server.AddDocuments(documents);
+    CHECK(errors.size() == expected_errors.size());
+    for (size_t i = 0; i < errors.size(); ++i) {
+        CHECK(errors[i].position == expected_errors[i].position);
+        CHECK(errors[i].document_id == expected_errors[i].document_id);
+        CHECK(!errors[i].message.empty());
+    }
+    CheckSameIndex(search_server, expected_server);
+}
+
+// AddDocument rejects the same documents with an exception
+void TestSameAsAddDocument() {
+    SearchServer search_server("and"s);
+    search_server.AddDocument(1, "cat and dog"s, DocumentStatus::ACTUAL, { 1 });
+    for (const auto& [document_id, text] : { pair{ 1, "white cat"s }, pair{ -1, "white cat"s }, pair{ 2, "white c\x01t"s } }) {
+        bool rejected = false;
+        try {
+            search_server.AddDocument(document_id, text, DocumentStatus::ACTUAL, { 1 });
+        }
+        catch (const invalid_argument&) {
+            rejected = true;
+        }
+        CHECK(rejected);
+        CHECK(search_server.AddDocuments({ { document_id, text, DocumentStatus::ACTUAL, { 1 } } }).size() == 1);
+    }
+    CHECK(search_server.GetDocumentCount() == 1);
+}
+
+int main() {
+    TestErrorsInBatch(PostingFormat::PLAIN);
+    TestErrorsInBatch(PostingFormat::COMPRESSED);
+    TestSameAsAddDocument();
+    return 0;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+// Stops the test with the failed condition and its line. Unlike assert, it also checks in release builds
+#define CHECK(condition)                                                                        \
+    do {                                                                                        \
+        if (!(condition)) {                                                                     \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #condition << std::endl; \
+            std::exit(1);                                                                       \
+        }                                                                                       \
+    } while (false)
@@ -0,0 +1,82 @@
+#include "concurrent_search_server.h"
+#include "process_queries.h"
+#include "generators.h"
+
+#include "check.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Checks that every result of the batch is a document of the copy it was found in
+bool AreValid(const SearchServer& search_server, const vector<vector<Document>>& results) {
+    for (const auto& documents : results) {
+        for (const auto& document : documents) {
+            if (!binary_search(search_server.begin(), search_server.end(), document.id)
+                || !isfinite(document.relevance)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ProcessQueries runs in reader threads while a writer keeps adding and removing documents.
+// Configure with -DSEARCH_SERVER_TSAN=ON to look for data races.
+// Usage: concurrent_update_stress_test [milliseconds] [reader_count]
+int main(int argc, char* argv[]) {
+    const int milliseconds = argc > 1 ? atoi(argv[1]) : 1'000;
+    const int reader_count = argc > 2 ? atoi(argv[2]) : 4;
+
+    mt19937 generator;
+    const auto dictionary = GenerateDictionary(generator, 1000, 10);
+    const auto documents = GenerateQueries(generator, dictionary, 4'000, 30);
+    const auto queries = GenerateQueries(generator, dictionary, 100, 5);
+
+    ConcurrentSearchServer search_server(dictionary[0]);
+    search_server.Modify([](SearchServer& server) {
+        server.SetResultCacheCapacity(50);
+    });
+    for (int i = 0; i < 1'000; ++i) {
+        search_server.AddDocument(i, documents[i], DocumentStatus::ACTUAL, { i % 7 });
+    }
+
+    atomic<bool> stopping = false;
+    atomic<size_t> batch_count = 0;
+    atomic<size_t> invalid_batch_count = 0;
+    vector<thread> readers;
+    for (int i = 0; i < reader_count; ++i) {
+        readers.emplace_back([&] {
+            while (!stopping) {
+                const auto server = search_server.Read();
+                if (!AreValid(*server, ProcessQueries(*server, queries))) {
+                    ++invalid_batch_count;
+                }
+                ++batch_count;
+            }
+        });
+    }
+
+    const auto end_time = chrono::steady_clock::now() + chrono::milliseconds(milliseconds);
+    for (int next_id = 1'000; next_id < 1'010 || chrono::steady_clock::now() < end_time; ++next_id) {
+        search_server.AddDocument(next_id, documents[next_id % documents.size()], DocumentStatus::ACTUAL, { next_id % 7 });
+        search_server.RemoveDocument(next_id - 1'000);
+    }
+    stopping = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    CHECK(batch_count > 0);
+    CHECK(invalid_batch_count == 0);
+    CHECK(search_server.Read()->GetDocumentCount() == 1'000);
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "search_server.h"
+
+#include "check.h"
+
+#include <cmath>
+#include <execution>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const vector<string> WORDS = { "cat"s, "dog"s, "tail"s, "curly"s, "white"s, "nasty"s, "eyes"s, "hat"s };
+
+string MakeText(mt19937& generator) {
+    string text;
+    for (int i = 0; i < 6; ++i) {
+        text += WORDS[generator() % WORDS.size()] + " "s;
+    }
+    return text;
+}
+
+void CheckSameResults(const SearchServer& search_server, const SearchServer& expected_server, const string& raw_query) {
+    for (const auto& [documents, expected_documents] : {
+            pair{ search_server.FindTopDocuments(raw_query), expected_server.FindTopDocuments(raw_query) },
+            pair{ search_server.FindTopDocuments(execution::par, raw_query), expected_server.FindTopDocuments(raw_query) },
+        }) {
+        CHECK(documents.size() == expected_documents.size());
+        for (size_t i = 0; i < documents.size(); ++i) {
+            CHECK(documents[i].id == expected_documents[i].id);
+            CHECK(abs(documents[i].relevance - expected_documents[i].relevance) < 1e-9);
+        }
+    }
+}
+
+// Documents keep coming and going, so internal ids are renumbered many times over,
+// and the server answers like one built from the documents it has at the end
+void TestChurn(PostingFormat posting_format) {
+    mt19937 generator(42);
+    SearchServer search_server("and"s, ThreadPool::GetDefault(), posting_format);
+    map<int, string> texts;
+    int next_id = 0;
+    for (int round = 0; round < 200; ++round) {
+        for (int i = 0; i < 8; ++i) {
+            texts[next_id] = MakeText(generator);
+            search_server.AddDocument(next_id, texts[next_id], DocumentStatus::ACTUAL, { next_id % 7 });
+            ++next_id;
+        }
+        for (int i = 0; i < 7 && !texts.empty(); ++i) {
+            auto it = texts.begin();
+            advance(it, generator() % texts.size());
+            if (round % 3 == 0) {
+                search_server.RemoveDocument(it->first);
+            }
+            else if (round % 3 == 1) {
+                search_server.RemoveDocument(execution::par, it->first);
+            }
+            else {
+                search_server.RemoveDocuments({ it->first });
+            }
+            texts.erase(it);
+        }
+    }
+
+    SearchServer expected_server("and"s);
+    for (const auto& [document_id, text] : texts) {
+        expected_server.AddDocument(document_id, text, DocumentStatus::ACTUAL, { document_id % 7 });
+    }
+    CHECK(search_server.GetDocumentCount() == expected_server.GetDocumentCount());
+    CheckSameResults(search_server, expected_server, "cat curly -hat"s);
+    CheckSameResults(search_server, expected_server, "dog eyes white"s);
+    for (const auto& [document_id, text] : texts) {
+        const string raw_query = "cat dog tail -nasty"s;
+        CHECK(search_server.MatchDocument(raw_query, document_id) == expected_server.MatchDocument(raw_query, document_id));
+        CHECK(search_server.GetWordFrequencies(document_id).size() == expected_server.GetWordFrequencies(document_id).size());
+    }
+}
+
+int main() {
+    TestChurn(PostingFormat::PLAIN);
+    TestChurn(PostingFormat::COMPRESSED);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "search_server.h"
+
+#include "check.h"
+
+#include <cmath>
+#include <execution>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Relevance after a removal is the one of a server that never had the document
+template <typename ExecutionPolicy>
+void TestRelevanceAfterRemoval(ExecutionPolicy policy) {
+    SearchServer search_server("and"s);
+    search_server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(2, "curly cat curly tail"s, DocumentStatus::ACTUAL, { 2 });
+    search_server.AddDocument(3, "nasty dog with big eyes"s, DocumentStatus::ACTUAL, { 3 });
+    search_server.RemoveDocument(policy, 2);
+
+    SearchServer expected_server("and"s);
+    expected_server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    expected_server.AddDocument(3, "nasty dog with big eyes"s, DocumentStatus::ACTUAL, { 3 });
+
+    const auto documents = search_server.FindTopDocuments("curly nasty cat"s);
+    const auto expected_documents = expected_server.FindTopDocuments("curly nasty cat"s);
+    CHECK(documents.size() == expected_documents.size());
+    for (size_t i = 0; i < documents.size(); ++i) {
+        CHECK(documents[i].id == expected_documents[i].id);
+        CHECK(abs(documents[i].relevance - expected_documents[i].relevance) < 1e-9);
+    }
+}
+
+// A word whose documents are all removed has no IDF left to divide by zero
+template <typename ExecutionPolicy>
+void TestWordOfRemovedDocuments(ExecutionPolicy policy) {
+    SearchServer search_server("and"s);
+    search_server.AddDocument(1, "white cat"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(2, "nasty dog"s, DocumentStatus::ACTUAL, { 2 });
+    search_server.RemoveDocument(policy, 2);
+
+    CHECK(search_server.FindTopDocuments("dog"s).empty());
+    const auto documents = search_server.FindTopDocuments("white dog"s);
+    CHECK(documents.size() == 1);
+    CHECK(documents[0].id == 1);
+    CHECK(isfinite(documents[0].relevance));
+}
+
+int main() {
+    TestRelevanceAfterRemoval(execution::seq);
+    TestRelevanceAfterRemoval(execution::par);
+    TestWordOfRemovedDocuments(execution::seq);
+    TestWordOfRemovedDocuments(execution::par);
+    return 0;
+}
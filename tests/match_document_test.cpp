@@ -0,0 +1,77 @@
+#include "search_server.h"
+
+#include "check.h"
+
+#include <execution>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+void AddDocuments(SearchServer& search_server) {
+    search_server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(2, "curly cat curly tail"s, DocumentStatus::BANNED, { 2 });
+}
+
+// Query words that no document has simply do not match
+template <typename Match>
+void TestWordsNotInIndex(Match match) {
+    SearchServer search_server("and"s);
+    AddDocuments(search_server);
+
+    const string raw_query = "curly parrot cat -eagle"s;
+    const auto [words, status] = match(search_server, raw_query, 2);
+    CHECK(words == vector<string_view>({ "cat"sv, "curly"sv }));
+    CHECK(status == DocumentStatus::BANNED);
+
+    const string unknown_query = "parrot -eagle"s;
+    const auto [unknown_words, unknown_status] = match(search_server, unknown_query, 1);
+    CHECK(unknown_words.empty());
+    CHECK(unknown_status == DocumentStatus::ACTUAL);
+}
+
+// The batch gives what MatchDocument gives for every document, in the order of the ids
+void TestMatchDocuments() {
+    SearchServer search_server("and"s);
+    AddDocuments(search_server);
+    search_server.AddDocument(3, "nasty dog with big eyes"s, DocumentStatus::ACTUAL, { 3 });
+
+    const string raw_query = "cat curly cat dog parrot -tail"s;
+    const vector<int> document_ids = { 3, 1, 2 };
+    const auto results = search_server.MatchDocuments(raw_query, document_ids);
+    CHECK(results.size() == document_ids.size());
+    for (size_t i = 0; i < document_ids.size(); ++i) {
+        CHECK(results[i] == search_server.MatchDocument(raw_query, document_ids[i]));
+    }
+    CHECK(get<0>(results[0]) == vector<string_view>({ "dog"sv }));
+    CHECK(get<0>(results[1]) == vector<string_view>({ "cat"sv }));
+    CHECK(get<0>(results[2]).empty());
+    CHECK(get<1>(results[2]) == DocumentStatus::BANNED);
+
+    CHECK(search_server.MatchDocuments(raw_query, {}).empty());
+
+    bool thrown = false;
+    try {
+        search_server.MatchDocuments(raw_query, { 1, 4 });
+    }
+    catch (const out_of_range&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+int main() {
+    TestWordsNotInIndex([](const SearchServer& search_server, const string& raw_query, int document_id) {
+        return search_server.MatchDocument(raw_query, document_id);
+    });
+    TestWordsNotInIndex([](const SearchServer& search_server, const string& raw_query, int document_id) {
+        return search_server.MatchDocument(execution::seq, raw_query, document_id);
+    });
+    TestWordsNotInIndex([](const SearchServer& search_server, const string& raw_query, int document_id) {
+        return search_server.MatchDocument(execution::par, raw_query, document_id);
+    });
+    TestMatchDocuments();
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include "search_server.h"
+
+#include "check.h"
+
+#include <cmath>
+#include <execution>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const vector<string> QUERIES = {
+    "all"s, "even"s, "span"s, "rare"s, "even third"s, "span -third"s, "all -even"s,
+    "rare span even"s, "third -rare"s, "all span rare -odd"s, "odd"s, "none"s,
+};
+
+// Ids grow by one at first and then by large steps, so blocks get different bit widths
+int GetDocumentId(int index) {
+    return index < 400 ? index : index * 1'000;
+}
+
+// Words occur in every document, in every few, or in a run of documents across
+// the block boundaries at 128 and 256, and repeat to give counts of several widths
+string MakeText(int index) {
+    string text = "all"s;
+    for (int i = 0; i < index % 5; ++i) {
+        text += " all"s;
+    }
+    text += index % 2 == 0 ? " even"s : " odd"s;
+    if (index % 3 == 0) {
+        text += " third third"s;
+    }
+    if (index >= 100 && index < 300) {
+        text += " span"s;
+    }
+    if (index % 127 == 0) {
+        text += " rare"s;
+    }
+    return text;
+}
+
+void CheckSameResults(const SearchServer& search_server, const SearchServer& expected_server) {
+    CHECK(search_server.GetDocumentCount() == expected_server.GetDocumentCount());
+    for (const string& query : QUERIES) {
+        for (const auto& [documents, expected_documents] : {
+                pair{ search_server.FindTopDocuments(query), expected_server.FindTopDocuments(query) },
+                pair{ search_server.FindTopDocuments(execution::par, query), expected_server.FindTopDocuments(execution::par, query) },
+                pair{ search_server.FindTopDocuments(query, DocumentStatus::ACTUAL, RatingRange{ 1, 2 }),
+                    expected_server.FindTopDocuments(query, DocumentStatus::ACTUAL, RatingRange{ 1, 2 }) },
+            }) {
+            CHECK(documents.size() == expected_documents.size());
+            for (size_t i = 0; i < documents.size(); ++i) {
+                CHECK(documents[i].id == expected_documents[i].id);
+                CHECK(abs(documents[i].relevance - expected_documents[i].relevance) < 1e-9);
+            }
+        }
+        for (const int document_id : expected_server) {
+            CHECK(search_server.MatchDocument(query, document_id) == expected_server.MatchDocument(query, document_id));
+        }
+    }
+}
+
+// Every change goes to a server of each format, which must keep answering alike
+void TestSameAsPlain() {
+    SearchServer compressed_server("and"s, ThreadPool::GetDefault(), PostingFormat::COMPRESSED);
+    SearchServer plain_server("and"s, ThreadPool::GetDefault(), PostingFormat::PLAIN);
+    const auto for_both = [&](const auto& change) {
+        change(compressed_server);
+        change(plain_server);
+        CheckSameResults(compressed_server, plain_server);
+    };
+
+    vector<string> texts;
+    for (int i = 0; i < 700; ++i) {
+        texts.push_back(MakeText(i));
+    }
+    for_both([&](SearchServer& server) {
+        for (int i = 0; i < 500; ++i) {
+            server.AddDocument(GetDocumentId(i), texts[i], DocumentStatus::ACTUAL, { i % 4 });
+        }
+    });
+    for_both([&](SearchServer& server) {
+        vector<DocumentInput> documents;
+        for (int i = 500; i < 700; ++i) {
+            documents.push_back({ GetDocumentId(i), texts[i], DocumentStatus::ACTUAL, { i % 4 } });
+        }
+        CHECK(server.AddDocuments(documents).empty());
+    });
+
+    // Single postings inside blocks and at their edges
+    for_both([](SearchServer& server) {
+        for (const int document_id : { 5, 127, 128, 129, 255, 256, 300 }) {
+            server.RemoveDocument(document_id);
+        }
+        server.RemoveDocument(execution::par, GetDocumentId(600));
+    });
+    // Most of a block at once
+    for_both([](SearchServer& server) {
+        vector<int> document_ids;
+        for (int document_id = 130; document_id < 250; ++document_id) {
+            document_ids.push_back(document_id);
+        }
+        server.RemoveDocuments(document_ids);
+    });
+    // A removed id comes back with other words
+    for_both([&](SearchServer& server) {
+        server.AddDocument(128, texts[3], DocumentStatus::ACTUAL, { 1 });
+        server.AddDocument(200, texts[254], DocumentStatus::ACTUAL, { 2 });
+    });
+}
+
+int main() {
+    TestSameAsPlain();
+    return 0;
+}
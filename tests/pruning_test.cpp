@@ -0,0 +1,99 @@
+#include "search_server.h"
+#include "generators.h"
+
+#include "check.h"
+
+#include <cmath>
+#include <execution>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+using Search = function<vector<Document>(const SearchServer&, const string&)>;
+
+void CheckSameDocuments(const vector<Document>& documents, const vector<Document>& expected_documents) {
+    CHECK(documents.size() == expected_documents.size());
+    for (size_t i = 0; i < documents.size(); ++i) {
+        CHECK(documents[i].id == expected_documents[i].id);
+        CHECK(abs(documents[i].relevance - expected_documents[i].relevance) < 1e-9);
+    }
+}
+
+// Dynamic pruning only skips documents that cannot make it into the top,
+// so the pruned search returns what the exhaustive one does
+void TestPrunedAsExhaustive(SearchServer& search_server, const vector<string>& queries, const Search& search) {
+    for (const string& query : queries) {
+        search_server.SetDynamicPruning(false);
+        const auto expected_documents = search(search_server, query);
+        search_server.SetDynamicPruning(true);
+        CheckSameDocuments(search(search_server, query), expected_documents);
+    }
+}
+
+// Pruning does skip postings on this corpus, so the comparisons above are not trivial
+void TestPruningSkipsPostings(SearchServer& search_server, const vector<string>& queries) {
+    search_server.SetDynamicPruning(false);
+    size_t scored_before = search_server.GetScoredPostingCount();
+    for (const string& query : queries) {
+        search_server.FindTopDocuments(query);
+    }
+    const size_t exhaustive_count = search_server.GetScoredPostingCount() - scored_before;
+
+    search_server.SetDynamicPruning(true);
+    scored_before = search_server.GetScoredPostingCount();
+    for (const string& query : queries) {
+        search_server.FindTopDocuments(query);
+    }
+    CHECK(search_server.GetScoredPostingCount() - scored_before < exhaustive_count);
+}
+
+int main() {
+    mt19937 generator;
+    const auto dictionary = GenerateIndexedDictionary(2'000);
+    const ZipfDistribution zipf(dictionary.size());
+    const auto documents = GenerateZipfTexts(generator, dictionary, zipf, 5'000, 10, 60);
+    auto queries = GenerateZipfTexts(generator, dictionary, zipf, 100, 1, 20);
+    const auto queries_with_minus_words = GenerateZipfTexts(generator, dictionary, zipf, 50, 1, 20, 0.1);
+    queries.insert(queries.end(), queries_with_minus_words.begin(), queries_with_minus_words.end());
+
+    const vector<Search> searches = {
+        [](const SearchServer& server, const string& query) {
+            return server.FindTopDocuments(execution::seq, query);
+        },
+        [](const SearchServer& server, const string& query) {
+            return server.FindTopDocuments(execution::par, query);
+        },
+        [](const SearchServer& server, const string& query) {
+            return server.FindTopDocuments(execution::seq, query, DocumentStatus::BANNED);
+        },
+        [](const SearchServer& server, const string& query) {
+            return server.FindTopDocuments(execution::par, query, DocumentStatus::BANNED);
+        },
+        [](const SearchServer& server, const string& query) {
+            return server.FindTopDocuments(execution::seq, query, DocumentStatus::ACTUAL, RatingRange{ 2, 4 });
+        },
+        [](const SearchServer& server, const string& query) {
+            return server.FindTopDocuments(execution::par, query, DocumentStatus::ACTUAL, RatingRange{ 2, 4 });
+        },
+        [](const SearchServer& server, const string& query) {
+            return server.FindTopDocuments(execution::seq, query,
+                [](int document_id, DocumentStatus, int) { return document_id % 3 == 0; }, 20);
+        },
+    };
+
+    for (const auto posting_format : { PostingFormat::PLAIN, PostingFormat::COMPRESSED }) {
+        SearchServer search_server(dictionary[0], ThreadPool::GetDefault(), posting_format);
+        for (size_t i = 0; i < documents.size(); ++i) {
+            const auto status = i % 5 == 0 ? DocumentStatus::BANNED : DocumentStatus::ACTUAL;
+            search_server.AddDocument(i, documents[i], status, { static_cast<int>(i % 7) });
+        }
+        for (const auto& search : searches) {
+            TestPrunedAsExhaustive(search_server, queries, search);
+        }
+        TestPruningSkipsPostings(search_server, queries);
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "search_server.h"
+#include "generators.h"
+
+#include "check.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static atomic<size_t> allocation_count = 0;
+// Bytes allocated and not freed yet
+static atomic<long long> live_bytes = 0;
+
+// Every block starts with its size, so that operator delete can count the bytes it frees
+static constexpr size_t SIZE_HEADER = alignof(max_align_t);
+
+void* operator new(size_t size) {
+    ++allocation_count;
+    live_bytes += size;
+    if (auto* ptr = static_cast<char*>(malloc(size + SIZE_HEADER))) {
+        *reinterpret_cast<size_t*>(ptr) = size;
+        return ptr + SIZE_HEADER;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    auto* block = static_cast<char*>(ptr) - SIZE_HEADER;
+    live_bytes -= *reinterpret_cast<size_t*>(block);
+    free(block);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+SearchServer MakeServer(mt19937& generator, const vector<string>& dictionary) {
+    const auto documents = GenerateQueries(generator, dictionary, 10'000, 70);
+    SearchServer search_server(dictionary[0]);
+    for (size_t i = 0; i < documents.size(); ++i) {
+        search_server.AddDocument(i, documents[i], DocumentStatus::ACTUAL, { 1, 2, 3 });
+    }
+    return search_server;
+}
+
+// Returns the allocations a pass over the queries makes besides the returned vectors
+size_t CountAllocations(const SearchServer& search_server, const vector<string>& queries) {
+    const size_t allocations_before = allocation_count;
+    size_t result_count = 0;
+    for (const string_view query : queries) {
+        result_count += !search_server.FindTopDocuments(query).empty();
+    }
+    return allocation_count - allocations_before - result_count;
+}
+
+// Once the query arena of the thread has grown, a sequential query allocates nothing but its result
+void TestSteadyQueries(const SearchServer& search_server, const vector<string>& queries) {
+    CountAllocations(search_server, queries);
+    CHECK(CountAllocations(search_server, queries) == 0);
+}
+
+// A query that needs more than the retained buffers takes the rest from the heap, and
+// its thread keeps no more than 1 MiB of query arena and 1 MiB of query words afterwards,
+// which still fit the usual queries without allocations
+void TestQueryPastBufferLimit(const SearchServer& search_server, const vector<string>& queries,
+    const string& huge_query) {
+    static constexpr long long MAX_RETAINED_SIZE = 2 * 1024 * 1024;
+    CountAllocations(search_server, queries);
+    const long long live_bytes_before = live_bytes;
+    for (int i = 0; i < 3; ++i) {
+        CHECK(!search_server.FindTopDocuments(huge_query).empty());
+        CHECK(live_bytes - live_bytes_before <= MAX_RETAINED_SIZE);
+    }
+    CHECK(CountAllocations(search_server, queries) == 0);
+}
+
+int main() {
+    mt19937 generator;
+
+    // Long words do not fit into the small string buffer, so every std::string
+    // temporary built from a query word costs a heap allocation
+    const auto dictionary = GenerateDictionary(generator, 1000, 30);
+    const SearchServer search_server = MakeServer(generator, dictionary);
+    const auto queries = GenerateQueries(generator, dictionary, 100, 70);
+    // Its words alone take several MiB of the arena
+    const string huge_query = GenerateQuery(generator, dictionary, 300'000);
+
+    TestSteadyQueries(search_server, queries);
+    TestQueryPastBufferLimit(search_server, queries, huge_query);
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "search_server.h"
+#include "generators.h"
+
+#include "check.h"
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Slot i of the batch holds what FindTopDocuments finds for query i, and the offsets
+// follow the number of documents each query found, which may be below max_result_count
+void TestSameAsFindTopDocuments(const SearchServer& search_server, const vector<string>& queries,
+    DocumentStatus status, size_t max_result_count) {
+    const auto results = search_server.FindTopDocumentsBatch(queries, status, max_result_count);
+    CHECK(results.offsets.size() == queries.size() + 1);
+    CHECK(results.offsets.front() == 0);
+    CHECK(results.offsets.back() == results.documents.size());
+    size_t short_result_count = 0;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const auto expected_documents = search_server.FindTopDocuments(queries[i], status, max_result_count);
+        CHECK(results.offsets[i + 1] - results.offsets[i] == expected_documents.size());
+        short_result_count += expected_documents.size() < max_result_count;
+        for (size_t j = 0; j < expected_documents.size(); ++j) {
+            const Document& document = results.documents[results.offsets[i] + j];
+            CHECK(document.id == expected_documents[j].id);
+            CHECK(document.rating == expected_documents[j].rating);
+            CHECK(abs(document.relevance - expected_documents[j].relevance) < 1e-9);
+        }
+    }
+    CHECK(short_result_count > 0);
+}
+
+int main() {
+    mt19937 generator;
+    const auto dictionary = GenerateIndexedDictionary(3'000);
+    const ZipfDistribution zipf(dictionary.size());
+    const auto texts = GenerateZipfTexts(generator, dictionary, zipf, 2'000, 5, 40);
+    auto queries = GenerateZipfTexts(generator, dictionary, zipf, 200, 1, 6, 0.2);
+    // Rare words find a document or two, unknown words and stop words none
+    queries.insert(queries.end(), {
+        dictionary.back(), dictionary[dictionary.size() - 2] + " "s + dictionary.back(),
+        "unknownword"s, "a"s, "a -b"s, dictionary[1] + " -"s + dictionary[1], queries[0], queries[1],
+    });
+
+    for (const auto posting_format : { PostingFormat::PLAIN, PostingFormat::COMPRESSED }) {
+        SearchServer search_server("a"s, ThreadPool::GetDefault(), posting_format);
+        for (size_t i = 0; i < texts.size(); ++i) {
+            const auto status = i % 4 == 0 ? DocumentStatus::BANNED : DocumentStatus::ACTUAL;
+            search_server.AddDocument(i, texts[i], status, { static_cast<int>(i % 9) });
+        }
+        for (const bool dynamic_pruning : { true, false }) {
+            search_server.SetDynamicPruning(dynamic_pruning);
+            TestSameAsFindTopDocuments(search_server, queries, DocumentStatus::ACTUAL, MAX_RESULT_DOCUMENT_COUNT);
+            TestSameAsFindTopDocuments(search_server, queries, DocumentStatus::ACTUAL, 1);
+            TestSameAsFindTopDocuments(search_server, queries, DocumentStatus::BANNED, 20);
+        }
+        // Cached results fill the slots as well
+        search_server.SetResultCacheCapacity(100);
+        TestSameAsFindTopDocuments(search_server, queries, DocumentStatus::ACTUAL, MAX_RESULT_DOCUMENT_COUNT);
+        TestSameAsFindTopDocuments(search_server, queries, DocumentStatus::ACTUAL, MAX_RESULT_DOCUMENT_COUNT);
+        CHECK(search_server.GetResultCacheStats().hits > 0);
+    }
+    return 0;
+}
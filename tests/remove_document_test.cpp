@@ -0,0 +1,74 @@
+#include "search_server.h"
+
+#include "check.h"
+
+#include <execution>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+vector<int> FindDocumentIds(const SearchServer& search_server, const string& raw_query) {
+    vector<int> document_ids;
+    for (const Document& document : search_server.FindTopDocuments(raw_query)) {
+        document_ids.push_back(document.id);
+    }
+    return document_ids;
+}
+
+void AddDocuments(SearchServer& search_server) {
+    search_server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(2, "curly cat curly tail"s, DocumentStatus::ACTUAL, { 2 });
+    search_server.AddDocument(3, "nasty dog with big eyes"s, DocumentStatus::ACTUAL, { 3 });
+}
+
+// Removal takes the postings of the document only, and the same id can be added again
+template <typename Remove>
+void TestRemoveThenAddAgain(Remove remove) {
+    SearchServer search_server("and with"s);
+    AddDocuments(search_server);
+    remove(search_server, 2);
+
+    CHECK(search_server.GetDocumentCount() == 2);
+    CHECK(FindDocumentIds(search_server, "cat"s) == vector<int>({ 1 }));
+    CHECK(FindDocumentIds(search_server, "curly"s).empty());
+
+    search_server.AddDocument(2, "curly dog"s, DocumentStatus::ACTUAL, { 2 });
+    CHECK(search_server.GetDocumentCount() == 3);
+    CHECK(FindDocumentIds(search_server, "cat"s) == vector<int>({ 1 }));
+    CHECK(FindDocumentIds(search_server, "curly"s) == vector<int>({ 2 }));
+    CHECK(FindDocumentIds(search_server, "tail"s).empty());
+
+    const string raw_query = "curly dog tail"s;
+    const auto [words, status] = search_server.MatchDocument(raw_query, 2);
+    CHECK(words == vector<string_view>({ "curly"sv, "dog"sv }));
+    CHECK(status == DocumentStatus::ACTUAL);
+}
+
+// Unknown ids are ignored
+void TestRemoveUnknownDocument() {
+    SearchServer search_server("and with"s);
+    AddDocuments(search_server);
+    search_server.RemoveDocument(4);
+    search_server.RemoveDocument(execution::par, 4);
+    search_server.RemoveDocuments({ 4, 5 });
+    CHECK(search_server.GetDocumentCount() == 3);
+    CHECK(FindDocumentIds(search_server, "cat"s).size() == 2);
+}
+
+int main() {
+    TestRemoveThenAddAgain([](SearchServer& search_server, int document_id) {
+        search_server.RemoveDocument(document_id);
+    });
+    TestRemoveThenAddAgain([](SearchServer& search_server, int document_id) {
+        search_server.RemoveDocument(execution::seq, document_id);
+    });
+    TestRemoveThenAddAgain([](SearchServer& search_server, int document_id) {
+        search_server.RemoveDocument(execution::par, document_id);
+    });
+    TestRemoveThenAddAgain([](SearchServer& search_server, int document_id) {
+        search_server.RemoveDocuments({ document_id });
+    });
+    TestRemoveUnknownDocument();
+    return 0;
+}
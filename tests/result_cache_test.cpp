@@ -0,0 +1,89 @@
+#include "search_server.h"
+
+#include "check.h"
+
+#include <cmath>
+#include <execution>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const string QUERY = "curly cat -collar"s;
+
+bool AreSame(const vector<Document>& documents, const vector<Document>& expected_documents) {
+    if (documents.size() != expected_documents.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < documents.size(); ++i) {
+        if (documents[i].id != expected_documents[i].id
+            || abs(documents[i].relevance - expected_documents[i].relevance) >= 1e-9) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Results of every cached overload, each read twice so that the second read comes from the cache
+vector<vector<Document>> FindCached(const SearchServer& search_server) {
+    vector<vector<Document>> results;
+    for (int i = 0; i < 2; ++i) {
+        results = {
+            search_server.FindTopDocuments(QUERY, DocumentStatus::ACTUAL),
+            search_server.FindTopDocuments(execution::par, QUERY, DocumentStatus::ACTUAL),
+            search_server.FindTopDocuments(QUERY, DocumentStatus::ACTUAL, RatingRange{ 2, 5 }),
+        };
+        const auto batch_results = search_server.FindTopDocumentsBatch({ QUERY });
+        results.emplace_back(batch_results.documents.begin() + batch_results.offsets[0],
+            batch_results.documents.begin() + batch_results.offsets[1]);
+    }
+    return results;
+}
+
+// After a change a cached query answers like a server without the cache, and differently than before
+void TestInvalidation(const function<void(SearchServer&)>& change) {
+    SearchServer search_server("and"s);
+    search_server.SetResultCacheCapacity(16);
+    SearchServer expected_server("and"s);
+    for (SearchServer* server : { &search_server, &expected_server }) {
+        server->AddDocument(1, "curly cat"s, DocumentStatus::ACTUAL, { 3 });
+        server->AddDocument(2, "white cat and collar"s, DocumentStatus::ACTUAL, { 4 });
+        server->AddDocument(3, "curly dog"s, DocumentStatus::ACTUAL, { 1 });
+        server->AddDocument(4, "grey cat with curly tail"s, DocumentStatus::ACTUAL, { 2 });
+    }
+
+    const auto results_before = FindCached(search_server);
+    const auto hits_before = search_server.GetResultCacheStats().hits;
+    CHECK(hits_before > 0);
+
+    change(search_server);
+    change(expected_server);
+    const auto results = FindCached(search_server);
+    const auto expected_documents = expected_server.FindTopDocuments(QUERY, DocumentStatus::ACTUAL);
+    const auto expected_rated_documents = expected_server.FindTopDocuments(QUERY, DocumentStatus::ACTUAL, RatingRange{ 2, 5 });
+    for (size_t i = 0; i < results.size(); ++i) {
+        CHECK(AreSame(results[i], i == 2 ? expected_rated_documents : expected_documents));
+        CHECK(!AreSame(results[i], results_before[i]));
+    }
+}
+
+int main() {
+    TestInvalidation([](SearchServer& server) {
+        server.AddDocument(5, "curly curly cat"s, DocumentStatus::ACTUAL, { 5 });
+    });
+    TestInvalidation([](SearchServer& server) {
+        server.RemoveDocument(1);
+    });
+    TestInvalidation([](SearchServer& server) {
+        server.RemoveDocument(execution::par, 4);
+    });
+    TestInvalidation([](SearchServer& server) {
+        server.RemoveDocuments({ 1, 3 });
+    });
+    TestInvalidation([](SearchServer& server) {
+        CHECK(server.AddDocuments({ { 5, "curly curly cat"s, DocumentStatus::ACTUAL, { 5 } },
+            { 6, "cat in a curly collar"s, DocumentStatus::ACTUAL, { 2 } } }).empty());
+    });
+    return 0;
+}
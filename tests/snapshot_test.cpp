@@ -0,0 +1,148 @@
+#include "search_server.h"
+#include "index_snapshot.h"
+#include "generators.h"
+
+#include "check.h"
+
+#include <cmath>
+#include <cstddef>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const string STOP_WORDS = "a b"s;
+
+string GetSnapshotPath(const string& name) {
+    return (filesystem::temp_directory_path() / ("search_server_snapshot_test_"s + name)).string();
+}
+
+void CheckSameResults(const SearchServer& search_server, const SearchServer& expected_server,
+    const vector<string>& queries) {
+    CHECK(search_server.GetDocumentCount() == expected_server.GetDocumentCount());
+    for (const string& query : queries) {
+        for (const auto& [documents, expected_documents] : {
+                pair{ search_server.FindTopDocuments(query), expected_server.FindTopDocuments(query) },
+                pair{ search_server.FindTopDocuments(execution::par, query), expected_server.FindTopDocuments(execution::par, query) },
+                pair{ search_server.FindTopDocuments(query, DocumentStatus::BANNED), expected_server.FindTopDocuments(query, DocumentStatus::BANNED) },
+            }) {
+            CHECK(documents.size() == expected_documents.size());
+            for (size_t i = 0; i < documents.size(); ++i) {
+                CHECK(documents[i].id == expected_documents[i].id);
+                CHECK(documents[i].rating == expected_documents[i].rating);
+                CHECK(abs(documents[i].relevance - expected_documents[i].relevance) < 1e-9);
+            }
+        }
+    }
+    for (const int document_id : expected_server) {
+        CHECK(search_server.MatchDocument(queries[0], document_id) == expected_server.MatchDocument(queries[0], document_id));
+        CHECK(search_server.GetWordFrequencies(document_id).size() == expected_server.GetWordFrequencies(document_id).size());
+    }
+}
+
+// The server is saved after some removals, so the snapshot leaves out removed postings
+// and numbers the documents anew
+SearchServer MakeServer(PostingFormat posting_format, const vector<string>& texts) {
+    SearchServer search_server(STOP_WORDS, ThreadPool::GetDefault(), posting_format);
+    for (size_t i = 0; i < texts.size(); ++i) {
+        const auto status = i % 4 == 0 ? DocumentStatus::BANNED : DocumentStatus::ACTUAL;
+        search_server.AddDocument(i, texts[i], status, { static_cast<int>(i % 7), 3 });
+    }
+    for (size_t i = 0; i < texts.size(); i += 5) {
+        search_server.RemoveDocument(i);
+    }
+    return search_server;
+}
+
+// A loaded server answers like the one that was saved
+void TestRoundTrip(PostingFormat posting_format, const vector<string>& texts, const vector<string>& queries) {
+    const string path = GetSnapshotPath("round_trip"s);
+    const SearchServer search_server = MakeServer(posting_format, texts);
+    search_server.SaveSnapshot(path);
+    const SearchServer loaded_server = SearchServer::LoadSnapshot(path);
+    filesystem::remove(path);
+    CheckSameResults(loaded_server, search_server, queries);
+}
+
+// Posting lists of a loaded server are views into the file, and the first change of a list
+// copies it out. Changes reach the loaded server like any other
+void TestChangesAfterLoading(const vector<string>& texts, const vector<string>& queries) {
+    const string path = GetSnapshotPath("changes"s);
+    SearchServer search_server = MakeServer(PostingFormat::PLAIN, texts);
+    search_server.SaveSnapshot(path);
+    SearchServer loaded_server = SearchServer::LoadSnapshot(path);
+    filesystem::remove(path);
+
+    const int next_id = static_cast<int>(texts.size());
+    for (SearchServer* server : { &search_server, &loaded_server }) {
+        server->AddDocument(next_id, texts[1], DocumentStatus::ACTUAL, { 5 });
+        server->AddDocument(next_id + 1, "unseenword "s + texts[2], DocumentStatus::BANNED, { 1 });
+        server->RemoveDocument(3);
+        server->RemoveDocument(execution::par, 6);
+    }
+    CheckSameResults(loaded_server, search_server, queries);
+    CHECK(loaded_server.FindTopDocuments("unseenword"s, DocumentStatus::BANNED).size() == 1);
+
+    // Most documents go, so internal ids get renumbered
+    vector<int> removed_ids;
+    for (const int document_id : search_server) {
+        if (document_id % 3 != 0) {
+            removed_ids.push_back(document_id);
+        }
+    }
+    for (SearchServer* server : { &search_server, &loaded_server }) {
+        server->RemoveDocuments(removed_ids);
+    }
+    CheckSameResults(loaded_server, search_server, queries);
+}
+
+bool IsRejected(const string& path) {
+    try {
+        SearchServer::LoadSnapshot(path);
+    }
+    catch (const runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// A snapshot with any bit changed fails its checksum and is not loaded
+void TestCorruptedSnapshot(const vector<string>& texts) {
+    const string path = GetSnapshotPath("corrupted"s);
+    MakeServer(PostingFormat::PLAIN, texts).SaveSnapshot(path);
+    string bytes;
+    {
+        ifstream input(path, ios::binary);
+        bytes.assign(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+    }
+    CHECK(bytes.size() > sizeof(SnapshotHeader));
+
+    for (const size_t position : { offsetof(SnapshotHeader, checksum), sizeof(SnapshotHeader),
+            sizeof(SnapshotHeader) + (bytes.size() - sizeof(SnapshotHeader)) / 2, bytes.size() - 1 }) {
+        string corrupted_bytes = bytes;
+        corrupted_bytes[position] ^= 0x10;
+        ofstream(path, ios::binary | ios::trunc) << corrupted_bytes;
+        CHECK(IsRejected(path));
+    }
+    filesystem::remove(path);
+}
+
+int main() {
+    mt19937 generator;
+    const auto dictionary = GenerateIndexedDictionary(500);
+    const ZipfDistribution zipf(dictionary.size());
+    const auto texts = GenerateZipfTexts(generator, dictionary, zipf, 1'000, 5, 40);
+    const auto queries = GenerateZipfTexts(generator, dictionary, zipf, 30, 1, 8, 0.1);
+
+    TestRoundTrip(PostingFormat::PLAIN, texts, queries);
+    TestRoundTrip(PostingFormat::COMPRESSED, texts, queries);
+    TestChangesAfterLoading(texts, queries);
+    TestCorruptedSnapshot(texts);
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include "string_processing.h"
+
+#include "check.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// One character at a time, as SplitIntoValidWords did before it was vectorized
+size_t SplitScalar(string_view str, vector<string_view>& words) {
+    words.clear();
+    size_t first_invalid = string_view::npos;
+    size_t word_begin = 0;
+    for (size_t i = 0; i < str.size(); ++i) {
+        const unsigned char c = str[i];
+        if (c == ' ') {
+            words.push_back(str.substr(word_begin, i - word_begin));
+            word_begin = i + 1;
+        }
+        else if (c < ' ' && first_invalid == string_view::npos) {
+            first_invalid = i;
+        }
+    }
+    words.push_back(str.substr(word_begin));
+    return first_invalid;
+}
+
+void CheckSameAsScalar(string_view str) {
+    vector<string_view> expected_words;
+    const size_t expected_first_invalid = SplitScalar(str, expected_words);
+    // The words left from another text are replaced
+    vector<string_view> words = { "left"sv, "over"sv };
+    CHECK(SplitIntoValidWords(str, words) == expected_first_invalid);
+    CHECK(words == expected_words);
+    for (size_t i = 0; i < words.size(); ++i) {
+        CHECK(words[i].data() == expected_words[i].data());
+    }
+    CHECK(SplitIntoWords(str) == expected_words);
+}
+
+// A space or a control character at every position of texts a few vector widths long,
+// so they fall on both sides of the 16- and 32-byte block edges and into the tail
+void TestEveryPosition() {
+    for (size_t size = 0; size <= 100; ++size) {
+        const string text(size, 'w');
+        CheckSameAsScalar(text);
+        for (size_t i = 0; i < size; ++i) {
+            for (const char c : { ' ', '\x01', '\x1f', '\0', '\t' }) {
+                string changed_text = text;
+                changed_text[i] = c;
+                CheckSameAsScalar(changed_text);
+                // A second control character later on does not move the first one
+                if (i + 17 < size) {
+                    changed_text[i + 17] = '\x02';
+                    CheckSameAsScalar(changed_text);
+                }
+            }
+        }
+    }
+}
+
+// Leading, trailing and repeated spaces give empty words
+void TestSpaces() {
+    for (const string_view text : {
+            ""sv, " "sv, "   "sv, " cat"sv, "cat "sv, "  cat  dog  "sv, "cat     dog"sv,
+            "                 cat                                dog                 "sv }) {
+        CheckSameAsScalar(text);
+    }
+    vector<string_view> words;
+    CHECK(SplitIntoValidWords(" cat  dog "sv, words) == string_view::npos);
+    CHECK((words == vector<string_view>{ ""sv, "cat"sv, ""sv, "dog"sv, ""sv }));
+}
+
+// Bytes from 0x7f up are valid, even though char may be signed
+void TestHighBytes() {
+    CheckSameAsScalar("\x7f\x80\xc0\xff \xe0\xf1\xe5\xe2\xfb\xe9 \xea\xee\xf2 \xe8\xe4\xe5\xf2 \xef\xee \xea\xf0\xfb\xf8\xe5"sv);
+    vector<string_view> words;
+    CHECK(SplitIntoValidWords(string(40, '\xff'), words) == string_view::npos);
+}
+
+// Texts of random spaces, control characters and letters
+void TestRandomTexts() {
+    mt19937 generator;
+    const string alphabet = "  abcxyz\x01\x1f\x7f\x80\xff"s;
+    for (int i = 0; i < 2'000; ++i) {
+        string text(generator() % 300, ' ');
+        for (char& c : text) {
+            const uint32_t r = generator() % 100;
+            c = r < 80 ? 'a' + r % 26 : alphabet[r % alphabet.size()];
+        }
+        CheckSameAsScalar(text);
+    }
+}
+
+int main() {
+    TestEveryPosition();
+    TestSpaces();
+    TestHighBytes();
+    TestRandomTexts();
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include "search_server.h"
+
+#include "check.h"
+
+#include <cmath>
+#include <execution>
+#include <map>
+#include <string>
+
+using namespace std;
+
+map<string_view, double> GetWordFrequencies(const SearchServer& search_server, int document_id) {
+    map<string_view, double> word_freqs;
+    for (const auto& [term_id, term_freq] : search_server.GetWordFrequencies(document_id)) {
+        word_freqs.emplace(search_server.GetWord(term_id), term_freq);
+    }
+    return word_freqs;
+}
+
+void TestWordFrequencies() {
+    SearchServer search_server("and"s);
+    search_server.AddDocument(1, "curly cat curly tail"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(2, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 2 });
+
+    const auto word_freqs = GetWordFrequencies(search_server, 1);
+    CHECK(word_freqs.size() == 3);
+    CHECK(abs(word_freqs.at("curly"sv) - 0.5) < 1e-9);
+    CHECK(abs(word_freqs.at("cat"sv) - 0.25) < 1e-9);
+    CHECK(abs(word_freqs.at("tail"sv) - 0.25) < 1e-9);
+    CHECK(search_server.GetWordFrequencies(2).size() == 4);
+}
+
+// Unknown and removed documents have no words
+void TestWordFrequenciesOfMissingDocument() {
+    SearchServer search_server("and"s);
+    search_server.AddDocument(1, "curly cat curly tail"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(2, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 2 });
+
+    CHECK(search_server.GetWordFrequencies(3).empty());
+    CHECK(search_server.GetWordFrequencies(-1).empty());
+    search_server.RemoveDocument(execution::par, 1);
+    CHECK(search_server.GetWordFrequencies(1).empty());
+    CHECK(search_server.GetWordFrequencies(2).size() == 4);
+}
+
+int main() {
+    TestWordFrequencies();
+    TestWordFrequenciesOfMissingDocument();
+    return 0;
+}
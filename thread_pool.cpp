@@ -0,0 +1,104 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace {
+    // Set for the threads of a pool, so that tasks pushed from a worker
+    // go to its own deque and it looks there first
+    thread_local const ThreadPool* current_pool = nullptr;
+    thread_local size_t current_queue = 0;
+}
+
+ThreadPool::ThreadPool(size_t thread_count) {
+    thread_count = std::max<size_t>(thread_count, 1);
+    for (size_t i = 0; i < thread_count; ++i) {
+        queues_.push_back(std::make_unique<TaskQueue>());
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.emplace_back([this, i] {
+            WorkerLoop(i);
+        });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard guard(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::shared_ptr<ThreadPool> ThreadPool::GetDefault() {
+    static const auto pool = std::make_shared<ThreadPool>();
+    return pool;
+}
+
+size_t ThreadPool::GetThreadCount() const {
+    return workers_.size();
+}
+
+void ThreadPool::Push(Task task) {
+    const size_t queue_index = current_pool == this
+        ? current_queue
+        : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        auto& queue = *queues_[queue_index];
+        std::lock_guard guard(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    pending_count_.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard guard(wake_mutex_);
+    }
+    wake_.notify_one();
+}
+
+bool ThreadPool::RunPendingTask() {
+    if (pending_count_.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    const size_t first_queue = current_pool == this ? current_queue : 0;
+    for (size_t i = 0; i < queues_.size(); ++i) {
+        auto& queue = *queues_[(first_queue + i) % queues_.size()];
+        Task task;
+        {
+            std::lock_guard guard(queue.mutex);
+            if (queue.tasks.empty()) {
+                continue;
+            }
+            if (i == 0 && current_pool == this) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+        }
+        pending_count_.fetch_sub(1, std::memory_order_relaxed);
+        task();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::WorkerLoop(size_t index) {
+    current_pool = this;
+    current_queue = index;
+    while (true) {
+        if (RunPendingTask()) {
+            continue;
+        }
+        std::unique_lock lock(wake_mutex_);
+        wake_.wait(lock, [this] {
+            return stopping_ || pending_count_.load(std::memory_order_acquire) != 0;
+        });
+        if (stopping_) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent pool of workers, each with its own task deque. A worker takes
+// tasks from the back of its own deque and steals from the front of the others.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency());
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool();
+
+    // Pool shared by every SearchServer that was not given one explicitly
+    static std::shared_ptr<ThreadPool> GetDefault();
+
+    size_t GetThreadCount() const;
+
+    // Calls function(index) for every index in [0, count) and returns when all calls are done.
+    // The calling thread runs pending tasks while it waits, so calls may be nested.
+    // The first exception thrown by function is rethrown here.
+    template <typename Function>
+    void ParallelFor(size_t count, const Function& function);
+
+private:
+    using Task = std::function<void()>;
+
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void Push(Task task);
+
+    bool RunPendingTask();
+
+    void WorkerLoop(size_t index);
+
+    std::vector<std::unique_ptr<TaskQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> pending_count_ = 0;
+    std::atomic<size_t> next_queue_ = 0;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
+
+template <typename Function>
+void ThreadPool::ParallelFor(size_t count, const Function& function) {
+    if (count == 0) {
+        return;
+    }
+    if (count == 1) {
+        function(0);
+        return;
+    }
+
+    struct Group {
+        std::atomic<size_t> remaining;
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    } group;
+    group.remaining = count;
+
+    for (size_t index = 0; index < count; ++index) {
+        Push([&group, &function, index] {
+            try {
+                function(index);
+            }
+            catch (...) {
+                std::lock_guard guard(group.error_mutex);
+                if (!group.error) {
+                    group.error = std::current_exception();
+                }
+            }
+            group.remaining.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    while (group.remaining.load(std::memory_order_acquire) != 0) {
+        if (!RunPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+    if (group.error) {
+        std::rethrow_exception(group.error);
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <vector>
+
+#include "document.h"
+#include "thread_pool.h"
+
+const double eps = 1e-6;
+
+// Search result order: by relevance, and by rating when relevances differ by less than eps
+inline bool IsMoreRelevant(const Document& lhs, const Document& rhs) {
+    if (std::abs(lhs.relevance - rhs.relevance) < eps) {
+        return lhs.rating > rhs.rating;
+    }
+    else {
+        return lhs.relevance > rhs.relevance;
+    }
+}
+
+// Keeps only the max_count most relevant documents, sorted by IsMoreRelevant.
+// Documents is a vector of Document with any allocator
+template <typename Documents>
+void SelectTopDocuments(const std::execution::sequenced_policy&, Documents& documents, size_t max_count) {
+    if (documents.size() > max_count) {
+        std::partial_sort(documents.begin(), documents.begin() + max_count, documents.end(), IsMoreRelevant);
+        documents.resize(max_count);
+    }
+    else {
+        std::sort(documents.begin(), documents.end(), IsMoreRelevant);
+    }
+}
+
+// Every part of documents selects its own top on thread_pool, then the winners of the parts are merged
+inline void SelectTopDocuments(ThreadPool& thread_pool,
+    std::vector<Document>& documents, size_t max_count) {
+    const size_t part_count = thread_pool.GetThreadCount();
+    const size_t part_length = documents.size() / part_count;
+    if (part_count == 1 || part_length <= max_count) {
+        SelectTopDocuments(std::execution::seq, documents, max_count);
+        return;
+    }
+
+    thread_pool.ParallelFor(part_count,
+        [&documents, part_count, part_length, max_count](size_t part) {
+            const auto part_begin = documents.begin() + part * part_length;
+            const auto part_end = part == part_count - 1 ? documents.end() : part_begin + part_length;
+            std::partial_sort(part_begin, part_begin + max_count, part_end, IsMoreRelevant);
+        }
+    );
+
+    std::vector<Document> part_tops;
+    part_tops.reserve(part_count * max_count);
+    for (size_t part = 0; part < part_count; ++part) {
+        const auto part_begin = documents.begin() + part * part_length;
+        part_tops.insert(part_tops.end(), part_begin, part_begin + max_count);
+    }
+    SelectTopDocuments(std::execution::seq, part_tops, max_count);
+    documents = std::move(part_tops);
+}